@@ -0,0 +1,22 @@
+#shader vertex
+#version 330 core
+
+/* Drawn in place of a program that is still compiling, reads nothing but the position */
+layout(location = 0) in vec4 position;
+
+uniform mat4 u_MVP;
+
+void main()
+{
+   gl_Position = u_MVP * position;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+void main()
+{
+	color = vec4(0.5, 0.5, 0.5, 1.0);
+};
\ No newline at end of file
@@ -0,0 +1,31 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 2) in vec2 offset;
+
+out vec2 v_TexCoord;
+
+uniform mat4 u_MVP;
+uniform float u_Scale;
+
+void main()
+{
+   gl_Position = u_MVP * vec4(position.xy * u_Scale + offset, 0.0, 1.0);
+   v_TexCoord = texCoord;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+	color = texture(u_Texture, v_TexCoord);
+};
@@ -0,0 +1,45 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+/* A float normal, or a GL_INT_2_10_10_10_REV octahedral encoding in xy when u_OctahedralNormals is set */
+layout(location = 2) in vec4 normal;
+
+out vec2 v_TexCoord;
+out vec3 v_Normal;
+
+uniform mat4 u_MVP;
+uniform int u_OctahedralNormals;
+
+vec3 DecodeOctahedral(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	if (n.z < 0.0)
+		n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	return normalize(n);
+}
+
+void main()
+{
+	gl_Position = u_MVP * position;
+	v_TexCoord = texCoord;
+	v_Normal = u_OctahedralNormals != 0 ? DecodeOctahedral(normal.xy) : normal.xyz;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+in vec3 v_Normal;
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+	float diffuse = max(dot(normalize(v_Normal), normalize(vec3(0.3, 0.8, 0.5))), 0.0);
+	vec4 texColor = texture(u_Texture, v_TexCoord);
+	color = vec4(texColor.rgb * (0.2 + 0.8 * diffuse), texColor.a);
+};
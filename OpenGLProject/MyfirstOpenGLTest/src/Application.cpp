@@ -14,11 +14,22 @@
 #include "VertexArray.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "BatchRenderer.h"
+#include "VertexArrayCache.h"
+#include "RenderQueue.h"
+#include "RenderThread.h"
+#include "RecordBenchmark.h"
+#include "GpuProfiler.h"
+#include "Profiler.h"
+#include "GLDebug.h"
+#include "ErrorCheckBenchmark.h"
+#include "MeshOptimizerBenchmark.h"
+#include "ShaderCacheBenchmark.h"
 
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 
-int main(void)
+int main(int argc, char** argv)
 {
     GLFWwindow* window;
 
@@ -26,6 +37,11 @@ int main(void)
     if (!glfwInit())
         return -1;
 
+#if defined(_DEBUG) || GL_ERROR_CHECK != GL_ERROR_CHECK_OFF
+    /* Ask for a debug context so KHR_debug messages are delivered, release builds skip its overhead */
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#endif
+
     /* Create a windowed mode window and its OpenGL context */
     window = glfwCreateWindow(640, 480, "OpenGLWindow", NULL, NULL);
     if (!window)
@@ -47,6 +63,14 @@ int main(void)
 
      /* Output the version of OpenGL */
     std::cout << glGetString(GL_VERSION) << std::endl;
+
+#if defined(_DEBUG) || GL_ERROR_CHECK != GL_ERROR_CHECK_OFF
+    /* GL errors are reported through debug output, GLCall only samples glGetError as a fallback */
+    if (!GLDebug::Get().Init())
+    {
+        std::cout << "KHR_debug not available, relying on glGetError" << std::endl;
+    }
+#endif
     {
 #pragma region buffer
 
@@ -68,7 +92,7 @@ int main(void)
 
         unsigned int vao;
         GLCall(glGenVertexArrays(1, &vao));
-        GLCall(glBindVertexArray(vao));
+        GLState::Get().BindVertexArray(vao);
 
         VertexArray vertexArray;
 
@@ -81,7 +105,7 @@ int main(void)
         vertexArray.Addbuffer(vertexBuffer, vertexBufferLayout);
 
         /* Get Buffers */
-        IndexBuffer indexBuffer(indices, 6 * sizeof(unsigned int));
+        IndexBuffer indexBuffer(indices);
 
 #pragma endregion
 
@@ -109,39 +133,200 @@ int main(void)
         float increment = 0.05f;
 
         Renderer renderer;
+        RenderQueue renderQueue;
+
+        Shader batchShader("res/shaders/Batch.shader");
+        BatchRenderer batchRenderer(batchShader);
+
+        GpuProfiler gpuProfiler;
+
+        /* Pass --bench-record to measure multi-threaded draw recording and exit */
+        if (argc > 1 && std::string(argv[1]) == "--bench-record")
+        {
+            RunRecordBenchmark(vertexArray, indexBuffer, shader, texture);
+            glfwSetWindowShouldClose(window, GLFW_TRUE);
+        }
+
+        /* Pass --bench-errors to compare the cost of the error checking modes and exit */
+        if (argc > 1 && std::string(argv[1]) == "--bench-errors")
+        {
+            RunErrorCheckBenchmark(shader);
+            glfwSetWindowShouldClose(window, GLFW_TRUE);
+        }
+
+        /* Pass --bench-mesh to compare post-transform cache efficiency before and after MeshOptimizer and exit */
+        if (argc > 1 && std::string(argv[1]) == "--bench-mesh")
+        {
+            RunMeshOptimizerBenchmark();
+            glfwSetWindowShouldClose(window, GLFW_TRUE);
+        }
+
+        /* Pass --bench-shaders to compare startup shader creation with a cold and a warm program binary cache and asynchronous compilation and exit */
+        if (argc > 1 && std::string(argv[1]) == "--bench-shaders")
+        {
+            /* A hidden window whose context shares objects with the main one, for ShaderCompiler's worker mode */
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            GLFWwindow* compileWindow = glfwCreateWindow(1, 1, "", NULL, window);
+            glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+            ShaderCompiler::ContextBinder workerContext;
+            if (compileWindow)
+            {
+                workerContext = [compileWindow](bool current) { glfwMakeContextCurrent(current ? compileWindow : NULL); };
+            }
+
+            RunShaderCacheBenchmark(workerContext);
+
+            if (compileWindow)
+            {
+                glfwDestroyWindow(compileWindow);
+            }
+            glfwSetWindowShouldClose(window, GLFW_TRUE);
+        }
+
+        /* Pass --render-thread to replay the GL commands on a dedicated thread */
+        bool useRenderThread = argc > 1 && std::string(argv[1]) == "--render-thread";
+        RenderThread renderThread(window, renderer);
+        if (useRenderThread)
+        {
+            renderThread.Start();
+        }
+
+        /* Press P to write the CPU zones recorded so far as a chrome://tracing file */
+        bool traceKeyDown = false;
 
         /* Loop until the user closes the window */
         while (!glfwWindowShouldClose(window))
         {
-            /* Render here */
-            renderer.Clear();
+            PROFILE_SCOPE("Frame");
 
-            /* Draw the triangle */
-            shader.Bind();
-            shader.SetUniform4f("u_Color", red, green, blue, 1.0f);
+            if (useRenderThread)
+            {
+                PROFILE_SCOPE("Record");
+                /* Only record here, the render thread replays it while the next frame is recorded */
+                CommandList& commands = renderThread.GetRecordList();
+                commands.Clear();
+                commands.SetUniform4f(shader, "u_Color", red, green, blue, 1.0f);
+                commands.BindTexture(texture);
+                commands.Draw(vertexArray, indexBuffer, shader);
+                renderThread.SubmitFrame();
+            }
+            else
+            {
+                PROFILE_SCOPE("Render");
+
+                /* Render here */
+                GLState::Get().ResetStats();
+                gpuProfiler.BeginFrame();
+                renderer.Clear();
+
+                /* Draw a grid of quads behind the triangle in as few draw calls as possible */
+                {
+                    GpuScope scope(gpuProfiler, "Batch");
+                    GLDebugGroup group("Batch");
+                    batchRenderer.ResetStats();
+                    batchRenderer.Begin(projection);
+                    for (float y = -3.0f; y < 3.0f; y += 0.25f)
+                    {
+                        for (float x = -4.0f; x < 4.0f; x += 0.25f)
+                        {
+                            glm::vec4 color = { (x + 4.0f) / 8.0f, 0.2f, (y + 3.0f) / 6.0f, 1.0f };
+                            batchRenderer.DrawQuad({ x, y }, { 0.2f, 0.2f }, texture, color);
+                        }
+                    }
+                    batchRenderer.End();
+                }
+
+                /* Draw the triangle */
+                {
+                    GpuScope scope(gpuProfiler, "Queue");
+                    GLDebugGroup group("Queue");
+                    shader.Bind();
+                    shader.SetUniform4f("u_Color", red, green, blue, 1.0f);
+
+                    /* The texture has an alpha channel and GL_BLEND is on, so it sorts as translucent */
+                    renderQueue.Submit(vertexArray, indexBuffer, shader, &texture, projection, 0.5f, true);
+                    renderQueue.Flush(renderer);
+                }
+                gpuProfiler.EndFrame();
+
+                /* Swap front and back buffers */
+                PROFILE_SCOPE("SwapBuffers");
+                glfwSwapBuffers(window);
+            }
 
-            renderer.Draw(vertexArray, indexBuffer, shader);
+            {
+                PROFILE_SCOPE("Update");
+
+                if (red > 1.0f)
+                {
+                    increment = -0.05f;
+                }
+                else if (red < 0.0f)
+                {
+                    increment = 0.05f;
+                }
+
+                red += increment;
+                green += increment;
+                blue += increment;
+            }
 
-            if (red > 1.0f)
+            /* Poll for and process events */
             {
-                increment = -0.05f;
+                PROFILE_SCOPE("PollEvents");
+                glfwPollEvents();
             }
-            else if (red < 0.0f)
+
+            bool traceKey = glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS;
+            if (traceKey && !traceKeyDown)
             {
-                increment = 0.05f;
+                if (Profiler::Get().WriteChromeTrace("trace.json"))
+                {
+                    std::cout << "Wrote trace.json" << std::endl;
+                }
             }
+            traceKeyDown = traceKey;
+        }
 
-            red += increment;
-            green += increment;
-            blue += increment;
+        renderThread.Stop();
 
-            /* Swap front and back buffers */
-            glfwSwapBuffers(window);
+        if (useRenderThread)
+        {
+            /* Record and execute overlap when the main thread rarely waits in SubmitFrame */
+            RenderThread::Timings timings = renderThread.GetTimings();
+            double frames = timings.FrameCount ? timings.FrameCount : 1;
+            std::cout << "Main thread: " << timings.RecordMs / frames << " ms record, "
+                << timings.SubmitWaitMs / frames << " ms waiting per frame" << std::endl;
+            std::cout << "Render thread: " << timings.ExecuteMs / frames << " ms execute, "
+                << timings.SwapMs / frames << " ms swap, " << timings.IdleMs / frames << " ms idle per frame" << std::endl;
+        }
+        else
+        {
+            const BatchRenderer::Stats& stats = batchRenderer.GetStats();
+            std::cout << "Batch: " << stats.DrawCount << " draws/frame, " << stats.GetQuadsPerDraw() << " quads/draw" << std::endl;
 
-            /* Poll for and process events */
-            glfwPollEvents();
+            const GLState::Stats& stateStats = GLState::Get().GetStats();
+            std::cout << "State changes: " << stateStats.Issued << " issued, " << stateStats.Elided << " elided per frame" << std::endl;
+
+            for (const std::string& name : gpuProfiler.GetScopeNames())
+            {
+                GpuProfiler::ScopeStats scope = gpuProfiler.GetScopeStats(name);
+                std::cout << "GPU " << name << ": min " << scope.MinMs << " avg " << scope.AvgMs
+                    << " max " << scope.MaxMs << " p99 " << scope.P99Ms << " ms" << std::endl;
+            }
+
+            const GpuProfiler::FrameStats& frame = gpuProfiler.GetLastFrame();
+            std::cout << "Frame: CPU " << frame.CpuMs << " ms, GPU " << frame.GpuMs << " ms, "
+                << (frame.GpuBound ? "GPU" : "CPU") << "-bound" << std::endl;
         }
+
+        std::cout << "Debug messages: " << GLDebug::Get().GetMessageCount() << " ("
+            << GLDebug::Get().GetSuppressedCount() << " duplicates suppressed)" << std::endl;
     }
+
+    /* The cache's destructor runs after glfwTerminate, delete its VAOs while the context is still current */
+    VertexArrayCache::Get().Clear();
     glfwTerminate();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "BatchRenderer.h"
+
+#include <algorithm>
+
+BatchRenderer::BatchRenderer(Shader& shader, unsigned int maxQuads /*= 10000*/)
+	: m_Shader(shader), m_MaxQuads(maxQuads), m_TextureSlotCount(MaxTextureSlots),
+	m_Vertices(nullptr), m_BaseVertex(0), m_QuadCount(0), m_MappedQuads(0), m_WhiteTexture(0), m_TextureSlotIndex(1)
+{
+	/* Never use more slots than the fragment stage can sample from */
+	int maxUnits = 0;
+	GLCall(glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxUnits));
+	m_TextureSlotCount = std::min(m_TextureSlotCount, (unsigned int)maxUnits);
+
+	m_VertexArray = std::make_unique<VertexArray>();
+	m_VertexBuffer = std::make_unique<StreamingVertexBuffer>((unsigned int)sizeof(QuadVertex), m_MaxQuads * 4);
+	m_VertexArray->Addbuffer(*m_VertexBuffer, QuadVertexLayout);
+
+	/* Every quad uses the same index pattern, so the index buffer is built once */
+	std::vector<unsigned int> indices(m_MaxQuads * 6);
+	unsigned int offset = 0;
+	for (unsigned int i = 0; i < indices.size(); i += 6)
+	{
+		indices[i + 0] = offset + 0;
+		indices[i + 1] = offset + 1;
+		indices[i + 2] = offset + 2;
+
+		indices[i + 3] = offset + 2;
+		indices[i + 4] = offset + 3;
+		indices[i + 5] = offset + 0;
+
+		offset += 4;
+	}
+	m_IndexBuffer = std::make_unique<IndexBuffer>(indices);
+
+	/* Slot 0 is a 1x1 white texture so untextured quads can share the batch */
+	unsigned int white = 0xffffffff;
+	GLCall(glGenTextures(1, &m_WhiteTexture));
+	GLState::Get().BindTexture(GL_TEXTURE_2D, m_WhiteTexture);
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &white));
+	GLState::Get().BindTexture(GL_TEXTURE_2D, 0);
+
+	m_TextureSlots.fill(0);
+	m_TextureSlots[0] = m_WhiteTexture;
+
+	int samplers[MaxTextureSlots];
+	for (int i = 0; i < (int)MaxTextureSlots; i++)
+		samplers[i] = i;
+
+	m_Shader.Bind();
+	m_Shader.SetUniform1iv("u_Textures", (int)m_TextureSlotCount, samplers);
+
+	m_VertexArray->UnBind();
+	m_VertexBuffer->UnBind();
+	m_IndexBuffer->UnBind();
+}
+
+BatchRenderer::~BatchRenderer()
+{
+	GLState::Get().OnDeleteTexture(m_WhiteTexture);
+	GLCall(glDeleteTextures(1, &m_WhiteTexture));
+}
+
+void BatchRenderer::Begin(const glm::mat4& viewProjection)
+{
+	m_Shader.Bind();
+	m_Shader.SetUniformMat4f("u_MVP", viewProjection);
+
+	m_QuadCount = 0;
+	m_TextureSlotIndex = 1;
+}
+
+void BatchRenderer::End()
+{
+	Flush();
+	m_VertexBuffer->EndFrame();
+}
+
+void BatchRenderer::DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color)
+{
+	DrawQuad({ position.x, position.y, 0.0f }, size, m_WhiteTexture, color);
+}
+
+void BatchRenderer::DrawQuad(const glm::vec2& position, const glm::vec2& size, const Texture& texture, const glm::vec4& tint)
+{
+	DrawQuad({ position.x, position.y, 0.0f }, size, texture.GetRendererID(), tint);
+}
+
+void BatchRenderer::DrawQuad(const glm::vec3& position, const glm::vec2& size, unsigned int textureID, const glm::vec4& color)
+{
+	if (m_Vertices && m_QuadCount >= m_MappedQuads)
+		Flush();
+
+	float texIndex = GetTextureSlot(textureID);
+
+	if (!m_Vertices)
+		MapBatch();
+
+	/* Mapped memory may be write-combined, write it front to back and never read it */
+	QuadVertex* vertex = m_Vertices + m_QuadCount * 4;
+	vertex[0] = { { position.x,          position.y,          position.z }, { 0.0f, 0.0f }, color, texIndex };
+	vertex[1] = { { position.x + size.x, position.y,          position.z }, { 1.0f, 0.0f }, color, texIndex };
+	vertex[2] = { { position.x + size.x, position.y + size.y, position.z }, { 1.0f, 1.0f }, color, texIndex };
+	vertex[3] = { { position.x,          position.y + size.y, position.z }, { 0.0f, 1.0f }, color, texIndex };
+
+	m_QuadCount++;
+}
+
+void BatchRenderer::ResetStats()
+{
+	m_Stats = Stats();
+}
+
+float BatchRenderer::GetTextureSlot(unsigned int textureID)
+{
+	for (unsigned int i = 0; i < m_TextureSlotIndex; i++)
+	{
+		if (m_TextureSlots[i] == textureID)
+			return (float)i;
+	}
+
+	/* Out of texture slots: submit what we have and start a new batch */
+	if (m_TextureSlotIndex >= m_TextureSlotCount)
+		Flush();
+
+	unsigned int slot = m_TextureSlotIndex++;
+	m_TextureSlots[slot] = textureID;
+	return (float)slot;
+}
+
+void BatchRenderer::MapBatch()
+{
+	/*
+	 * Take what is left of the current region rather than a whole one, so the
+	 * batches of a frame are packed into one region and only a region with no
+	 * room for another quad makes the buffer move on (and fence) or orphan
+	 */
+	unsigned int quads = std::min(m_MaxQuads, m_VertexBuffer->GetAvailableVertices() / 4);
+	if (quads == 0)
+		quads = m_MaxQuads;
+
+	m_Vertices = (QuadVertex*)m_VertexBuffer->Map(quads * 4, m_BaseVertex);
+	m_MappedQuads = quads;
+}
+
+void BatchRenderer::Flush()
+{
+	if (m_QuadCount == 0)
+		return;
+
+	m_VertexBuffer->Unmap(m_QuadCount * 4);
+	m_Vertices = nullptr;
+	m_MappedQuads = 0;
+
+	for (unsigned int i = 0; i < m_TextureSlotIndex; i++)
+		GLState::Get().BindTextureUnit(i, GL_TEXTURE_2D, m_TextureSlots[i]);
+
+	m_Shader.Bind();
+	m_Shader.FlushUniforms();
+	m_VertexArray->Bind();
+	m_IndexBuffer->Bind();
+	GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, m_QuadCount * 6, m_IndexBuffer->GetType(), nullptr, m_BaseVertex));
+
+	m_Stats.DrawCount++;
+	m_Stats.QuadCount += m_QuadCount;
+
+	m_QuadCount = 0;
+	m_TextureSlotIndex = 1;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "Renderer.h"
+#include "StreamingVertexBuffer.h"
+#include "StaticVertexLayout.h"
+#include "IndexBuffer.h"
+#include "VertexArray.h"
+#include "Shader.h"
+#include "Texture.h"
+
+#include "glm/glm.hpp"
+
+struct QuadVertex
+{
+	glm::vec3 Position;
+	glm::vec2 TexCoord;
+	glm::vec4 Color;
+	float TexIndex;
+};
+
+constexpr auto QuadVertexLayout = MakeVertexLayout<QuadVertex>(
+	VERTEX_ATTRIBUTE(QuadVertex, Position),
+	VERTEX_ATTRIBUTE(QuadVertex, TexCoord),
+	VERTEX_ATTRIBUTE(QuadVertex, Color),
+	VERTEX_ATTRIBUTE(QuadVertex, TexIndex));
+
+/*
+ * Writes textured quads straight into a streaming vertex buffer and submits
+ * them with one glDrawElementsBaseVertex per batch. A batch is flushed when it
+ * holds maxQuads quads or the texture slots are full, or when End() is called.
+ */
+class BatchRenderer
+{
+public:
+	static const unsigned int MaxTextureSlots = 16;
+
+	struct Stats
+	{
+		unsigned int DrawCount = 0;
+		unsigned int QuadCount = 0;
+
+		inline float GetQuadsPerDraw() const { return DrawCount ? (float)QuadCount / DrawCount : 0.0f; }
+	};
+
+	BatchRenderer(Shader& shader, unsigned int maxQuads = 10000);
+	~BatchRenderer();
+
+	void Begin(const glm::mat4& viewProjection);
+	void End();
+
+	void DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
+	void DrawQuad(const glm::vec2& position, const glm::vec2& size, const Texture& texture, const glm::vec4& tint = glm::vec4(1.0f));
+	void DrawQuad(const glm::vec3& position, const glm::vec2& size, unsigned int textureID, const glm::vec4& color);
+
+	inline const Stats& GetStats() const { return m_Stats; }
+	void ResetStats();
+private:
+	void Flush();
+	void MapBatch();
+	float GetTextureSlot(unsigned int textureID);
+private:
+	Shader& m_Shader;
+	unsigned int m_MaxQuads;
+	unsigned int m_TextureSlotCount;
+
+	std::unique_ptr<VertexArray> m_VertexArray;
+	std::unique_ptr<StreamingVertexBuffer> m_VertexBuffer;
+	std::unique_ptr<IndexBuffer> m_IndexBuffer;
+
+	/* Mapped vertices of the current batch, nullptr until its first quad */
+	QuadVertex* m_Vertices;
+	int m_BaseVertex;
+	unsigned int m_QuadCount;
+	/* Quads the current mapping has room for, at most m_MaxQuads */
+	unsigned int m_MappedQuads;
+
+	unsigned int m_WhiteTexture;
+	std::array<unsigned int, MaxTextureSlots> m_TextureSlots;
+	unsigned int m_TextureSlotIndex;
+
+	Stats m_Stats;
+};
@@ -0,0 +1,184 @@
+#include "BufferShadow.h"
+#include "Renderer.h"
+
+#include <algorithm>
+#include <cstring>
+
+unsigned int GetGLUsage(BufferUsage usage)
+{
+	switch (usage)
+	{
+	case BufferUsage::Static:	return GL_STATIC_DRAW;
+	case BufferUsage::Dynamic:	return GL_DYNAMIC_DRAW;
+	case BufferUsage::Stream:	return GL_STREAM_DRAW;
+	}
+	ASSERT(false);
+	return 0;
+}
+
+unsigned int GetGLStorageFlags(BufferUsage usage)
+{
+	switch (usage)
+	{
+	case BufferUsage::Static:	return 0;
+	case BufferUsage::Dynamic:	return GL_DYNAMIC_STORAGE_BIT;
+	case BufferUsage::Stream:	return GL_DYNAMIC_STORAGE_BIT | GL_CLIENT_STORAGE_BIT;
+	}
+	ASSERT(false);
+	return 0;
+}
+
+unsigned int CreateBuffer(unsigned int target, const void* data, unsigned int size, BufferUsage usage)
+{
+	unsigned int buffer = 0;
+	if (GLState::Get().UseDirectStateAccess())
+	{
+		/* glNamedBufferStorage rejects an empty store, the object alone is enough to bind */
+		GLCall(glCreateBuffers(1, &buffer));
+		if (size > 0)
+		{
+			GLCall(glNamedBufferStorage(buffer, size, data, GetGLStorageFlags(usage)));
+		}
+		return buffer;
+	}
+
+	GLCall(glGenBuffers(1, &buffer));
+	GLState::Get().BindBuffer(target, buffer);
+	GLCall(glBufferData(target, size, data, GetGLUsage(usage)));
+	return buffer;
+}
+
+void UploadBuffer(unsigned int buffer, unsigned int offset, const void* data, unsigned int size, BufferUsage usage)
+{
+	if (size == 0)
+		return;
+
+	if (GLState::Get().UseDirectStateAccess())
+	{
+		if (usage != BufferUsage::Static)
+		{
+			GLCall(glNamedBufferSubData(buffer, offset, size, data));
+			return;
+		}
+
+		/* Static stores are only written when they are filled, e.g. GeometryPool::Add, so the extra copy is rare */
+		unsigned int staging;
+		GLCall(glCreateBuffers(1, &staging));
+		GLCall(glNamedBufferStorage(staging, size, data, 0));
+		GLCall(glCopyNamedBufferSubData(staging, buffer, 0, offset, size));
+		GLCall(glDeleteBuffers(1, &staging));
+		return;
+	}
+
+	GLState::Get().BindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+	GLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data));
+}
+
+void DirtyRanges::Add(unsigned int offset, unsigned int size)
+{
+	if (size == 0)
+		return;
+
+	/* Sequential writes are the common case, grow the last range instead of appending */
+	if (!m_Ranges.empty())
+	{
+		Range& last = m_Ranges.back();
+		if (offset >= last.Begin && offset <= last.End + MergeGap)
+		{
+			last.End = std::max(last.End, offset + size);
+			return;
+		}
+	}
+
+	m_Ranges.push_back({ offset, offset + size });
+}
+
+const std::vector<DirtyRanges::Range>& DirtyRanges::Coalesce()
+{
+	if (m_Ranges.size() < 2)
+		return m_Ranges;
+
+	std::sort(m_Ranges.begin(), m_Ranges.end(), [](const Range& a, const Range& b) { return a.Begin < b.Begin; });
+
+	size_t merged = 0;
+	for (size_t i = 1; i < m_Ranges.size(); i++)
+	{
+		if (m_Ranges[i].Begin <= m_Ranges[merged].End + MergeGap)
+			m_Ranges[merged].End = std::max(m_Ranges[merged].End, m_Ranges[i].End);
+		else
+			m_Ranges[++merged] = m_Ranges[i];
+	}
+	m_Ranges.resize(merged + 1);
+
+	return m_Ranges;
+}
+
+static std::vector<BufferShadow*>& GetPending()
+{
+	static thread_local std::vector<BufferShadow*> s_Pending;
+	return s_Pending;
+}
+
+BufferShadow::BufferShadow(unsigned int rendererID, const void* data, unsigned int size)
+	: m_RendererID(rendererID), m_Data(size)
+{
+	if (data)
+		memcpy(m_Data.data(), data, size);
+}
+
+BufferShadow::~BufferShadow()
+{
+	auto& pending = GetPending();
+	pending.erase(std::remove(pending.begin(), pending.end(), this), pending.end());
+}
+
+void BufferShadow::Write(unsigned int offset, const void* data, unsigned int size)
+{
+	ASSERT(offset + size <= m_Data.size());
+
+	if (m_Dirty.IsEmpty())
+		GetPending().push_back(this);
+
+	memcpy(m_Data.data() + offset, data, size);
+	m_Dirty.Add(offset, size);
+	GetStats().Writes++;
+}
+
+void BufferShadow::Flush()
+{
+	if (m_Dirty.IsEmpty())
+		return;
+
+	Stats& stats = GetStats();
+	for (const auto& range : m_Dirty.Coalesce())
+	{
+		unsigned int end = std::min(range.End, (unsigned int)m_Data.size());
+		/* Only Dynamic and Stream buffers have a shadow, both stores take glNamedBufferSubData */
+		UploadBuffer(m_RendererID, range.Begin, m_Data.data() + range.Begin, end - range.Begin, BufferUsage::Dynamic);
+		stats.Uploads++;
+		stats.BytesUploaded += end - range.Begin;
+	}
+	m_Dirty.Clear();
+}
+
+void BufferShadow::FlushPending()
+{
+	auto& pending = GetPending();
+	if (pending.empty())
+		return;
+
+	for (BufferShadow* shadow : pending)
+		shadow->Flush();
+	pending.clear();
+}
+
+BufferShadow::Stats& BufferShadow::GetStats()
+{
+	static thread_local Stats s_Stats;
+	return s_Stats;
+}
+
+void BufferShadow::ResetStats()
+{
+	GetStats() = Stats();
+}
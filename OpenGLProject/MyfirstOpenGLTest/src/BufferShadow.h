@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+
+enum class BufferUsage
+{
+	Static, Dynamic, Stream
+};
+
+/* GL_STATIC_DRAW / GL_DYNAMIC_DRAW / GL_STREAM_DRAW */
+unsigned int GetGLUsage(BufferUsage usage);
+/* glBufferStorage flags: none for Static, GL_DYNAMIC_STORAGE_BIT otherwise, plus GL_CLIENT_STORAGE_BIT for Stream */
+unsigned int GetGLStorageFlags(BufferUsage usage);
+
+/*
+ * Creates a buffer holding size bytes of data (nullptr leaves it undefined).
+ * With direct state access the store is immutable and the bind points are
+ * untouched; otherwise it is bound to target and allocated with glBufferData.
+ * A size of 0 creates the buffer object without a store.
+ */
+unsigned int CreateBuffer(unsigned int target, const void* data, unsigned int size, BufferUsage usage);
+
+/*
+ * glBufferSubData by name with direct state access, else through
+ * GL_COPY_WRITE_BUFFER so no VAO binding changes. A Static buffer's immutable
+ * store takes no glNamedBufferSubData, it is written by copying from a
+ * temporary buffer instead.
+ */
+void UploadBuffer(unsigned int buffer, unsigned int offset, const void* data, unsigned int size, BufferUsage usage);
+
+/*
+ * Byte ranges written since the last flush. Ranges closer than MergeGap are
+ * merged: re-uploading a few unchanged bytes is cheaper than another call.
+ */
+class DirtyRanges
+{
+public:
+	static const unsigned int MergeGap = 256;
+
+	struct Range
+	{
+		unsigned int Begin;
+		unsigned int End;
+	};
+
+	void Add(unsigned int offset, unsigned int size);
+	/* Sorts and merges the ranges in place */
+	const std::vector<Range>& Coalesce();
+
+	inline void Clear() { m_Ranges.clear(); }
+	inline bool IsEmpty() const { return m_Ranges.empty(); }
+private:
+	std::vector<Range> m_Ranges;
+};
+
+/*
+ * CPU copy of a Dynamic or Stream buffer. Write() updates the copy and marks
+ * the range dirty, Flush() uploads the merged dirty ranges with one
+ * glBufferSubData each. A shadow with pending writes queues itself for the
+ * current thread and the Renderer calls FlushPending() before every draw, so
+ * owners only need to Write(). Must be used on the thread that owns the context.
+ */
+class BufferShadow
+{
+public:
+	struct Stats
+	{
+		unsigned int Writes = 0;
+		unsigned int Uploads = 0;
+		unsigned int BytesUploaded = 0;
+	};
+
+	BufferShadow(unsigned int rendererID, const void* data, unsigned int size);
+	~BufferShadow();
+
+	void Write(unsigned int offset, const void* data, unsigned int size);
+	void Flush();
+
+	static void FlushPending();
+
+	static Stats& GetStats();
+	static void ResetStats();
+private:
+	unsigned int m_RendererID;
+	std::vector<char> m_Data;
+	DirtyRanges m_Dirty;
+};
\ No newline at end of file
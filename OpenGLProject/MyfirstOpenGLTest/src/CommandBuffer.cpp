@@ -0,0 +1,27 @@
+#include "CommandBuffer.h"
+
+#include <algorithm>
+
+CommandBuffer::CommandBuffer(unsigned int capacity /*= 4096*/)
+	: m_Packets(new RenderCommand[capacity]), m_Count(0), m_Capacity(capacity)
+{
+}
+
+void CommandBuffer::Submit(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader, const Texture* texture,
+	const glm::mat4& mvp, float depth, bool translucent, unsigned int layer /*= 0*/)
+{
+	if (m_Count == m_Capacity)
+		Grow();
+
+	m_Packets[m_Count++] = RenderCommand::Make(vertexArray, indexBuffer, shader, texture, mvp, depth, translucent, layer);
+}
+
+void CommandBuffer::Grow()
+{
+	unsigned int capacity = std::max(m_Capacity * 2, 64u);
+	std::unique_ptr<RenderCommand[]> packets(new RenderCommand[capacity]);
+	std::copy(m_Packets.get(), m_Packets.get() + m_Count, packets.get());
+
+	m_Packets = std::move(packets);
+	m_Capacity = capacity;
+}
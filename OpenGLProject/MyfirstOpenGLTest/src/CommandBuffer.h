@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+
+#include "RenderQueue.h"
+
+/*
+ * Draw packets recorded by a single worker thread. Storage is a linear block
+ * that is reused every frame, so recording is a key computation and a store:
+ * no locks and, once the block has grown to the frame's size, no allocation.
+ * The buffers are handed to RenderQueue::Merge on the submitting thread.
+ *
+ * Buffers of different workers usually sit next to each other, the padding
+ * keeps their counters off a shared cache line. It is a full line rather than
+ * alignas(64), which a std::vector does not honour before C++17. Nothing reads
+ * it, hence [[maybe_unused]].
+ */
+class CommandBuffer
+{
+private:
+	std::unique_ptr<RenderCommand[]> m_Packets;
+	unsigned int m_Count;
+	unsigned int m_Capacity;
+	[[maybe_unused]] char m_Padding[64];
+public:
+	CommandBuffer(unsigned int capacity = 4096);
+
+	void Submit(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader, const Texture* texture,
+		const glm::mat4& mvp, float depth, bool translucent, unsigned int layer = 0);
+	/* Rewinds the allocator, the storage is kept for the next frame */
+	inline void Reset() { m_Count = 0; }
+
+	inline unsigned int GetCount() const { return m_Count; }
+	inline const RenderCommand* begin() const { return m_Packets.get(); }
+	inline const RenderCommand* end() const { return m_Packets.get() + m_Count; }
+private:
+	void Grow();
+};
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "CommandList.h"
+
+void CommandList::Reset()
+{
+	m_Commands.clear();
+}
+
+void CommandList::Clear()
+{
+	Push(FrameCommandType::Clear);
+}
+
+void CommandList::Draw(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader)
+{
+	FrameCommand& command = Push(FrameCommandType::Draw);
+	command.VertexArr = &vertexArray;
+	command.Indices = &indexBuffer;
+	command.Program = &shader;
+}
+
+void CommandList::BindTexture(const Texture& texture, unsigned int slot /*= 0*/)
+{
+	FrameCommand& command = Push(FrameCommandType::BindTexture);
+	command.Material = &texture;
+	command.IntValue = (int)slot;
+}
+
+void CommandList::SetUniform1i(Shader& shader, UniformID name, int value)
+{
+	FrameCommand& command = Push(FrameCommandType::SetUniform1i);
+	command.Program = &shader;
+	command.Name = name;
+	command.IntValue = value;
+}
+
+void CommandList::SetUniform1f(Shader& shader, UniformID name, float value)
+{
+	FrameCommand& command = Push(FrameCommandType::SetUniform1f);
+	command.Program = &shader;
+	command.Name = name;
+	command.Value[0][0] = value;
+}
+
+void CommandList::SetUniform4f(Shader& shader, UniformID name, float v0, float v1, float v2, float v3)
+{
+	FrameCommand& command = Push(FrameCommandType::SetUniform4f);
+	command.Program = &shader;
+	command.Name = name;
+	command.Value[0] = glm::vec4(v0, v1, v2, v3);
+}
+
+void CommandList::SetUniformMat4f(Shader& shader, UniformID name, const glm::mat4& matrix)
+{
+	FrameCommand& command = Push(FrameCommandType::SetUniformMat4f);
+	command.Program = &shader;
+	command.Name = name;
+	command.Value = matrix;
+}
+
+void CommandList::Execute(const Renderer& renderer) const
+{
+	for (const auto& command : m_Commands)
+	{
+		switch (command.Type)
+		{
+		case FrameCommandType::Clear:
+			renderer.Clear();
+			break;
+		case FrameCommandType::Draw:
+			renderer.Draw(*command.VertexArr, *command.Indices, *command.Program);
+			break;
+		case FrameCommandType::BindTexture:
+			command.Material->Bind((unsigned int)command.IntValue);
+			break;
+		case FrameCommandType::SetUniform1i:
+			command.Program->Bind();
+			command.Program->SetUniform1i(command.Name, command.IntValue);
+			break;
+		case FrameCommandType::SetUniform1f:
+			command.Program->Bind();
+			command.Program->SetUniform1f(command.Name, command.Value[0][0]);
+			break;
+		case FrameCommandType::SetUniform4f:
+			command.Program->Bind();
+			command.Program->SetUniform4f(command.Name, command.Value[0][0], command.Value[0][1], command.Value[0][2], command.Value[0][3]);
+			break;
+		case FrameCommandType::SetUniformMat4f:
+			command.Program->Bind();
+			command.Program->SetUniformMat4f(command.Name, command.Value);
+			break;
+		}
+	}
+}
+
+FrameCommand& CommandList::Push(FrameCommandType type)
+{
+	m_Commands.push_back({ type, nullptr, nullptr, nullptr, nullptr, "", 0, glm::mat4(1.0f) });
+	return m_Commands.back();
+}
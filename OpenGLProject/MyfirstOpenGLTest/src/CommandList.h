@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+#include "Renderer.h"
+#include "Texture.h"
+
+#include "glm/glm.hpp"
+
+enum class FrameCommandType
+{
+	Clear, Draw, BindTexture, SetUniform1i, SetUniform1f, SetUniform4f, SetUniformMat4f
+};
+
+struct FrameCommand
+{
+	FrameCommandType Type;
+	const VertexArray* VertexArr;
+	IndexBuffer* Indices;
+	Shader* Program;
+	const Texture* Material;
+	/* Only the hash is used to set the uniform, the name must outlive the frame for warnings (string literals) */
+	UniformID Name;
+	int IntValue;
+	glm::mat4 Value;
+};
+
+/*
+ * A frame worth of renderer-agnostic commands. Recording only appends to a
+ * vector and never touches GL, so it can happen on a thread without a context;
+ * Execute() replays the commands on the thread that owns the context.
+ */
+class CommandList
+{
+private:
+	std::vector<FrameCommand> m_Commands;
+public:
+	void Reset();
+
+	void Clear();
+	void Draw(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader);
+	void BindTexture(const Texture& texture, unsigned int slot = 0);
+
+	void SetUniform1i(Shader& shader, UniformID name, int value);
+	void SetUniform1f(Shader& shader, UniformID name, float value);
+	void SetUniform4f(Shader& shader, UniformID name, float v0, float v1, float v2, float v3);
+	void SetUniformMat4f(Shader& shader, UniformID name, const glm::mat4& matrix);
+
+	void Execute(const Renderer& renderer) const;
+
+	inline unsigned int GetCount() const { return (unsigned int)m_Commands.size(); }
+private:
+	FrameCommand& Push(FrameCommandType type);
+};
\ No newline at end of file
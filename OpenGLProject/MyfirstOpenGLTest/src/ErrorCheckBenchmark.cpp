@@ -0,0 +1,62 @@
+#include "ErrorCheckBenchmark.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "Renderer.h"
+#include "GLDebug.h"
+
+static double NowMs()
+{
+	using namespace std::chrono;
+	return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+void RunErrorCheckBenchmark(Shader& shader, unsigned int callCount /*= 200000*/)
+{
+	shader.Bind();
+	int location = glGetUniformLocation(shader.GetRendererID(), "u_Texture");
+	bool debugOutput = GLDebug::Get().IsEnabled();
+
+	/* Every mode ends with glFinish so queued work is paid for inside the measurement */
+	auto run = [&](const char* mode, int check)
+	{
+		if (debugOutput)
+		{
+			if (check == 1)
+				glEnable(GL_DEBUG_OUTPUT);
+			else
+				glDisable(GL_DEBUG_OUTPUT);
+		}
+
+		glFinish();
+		double start = NowMs();
+		for (unsigned int i = 0; i < callCount; i++)
+		{
+			if (check == 3)
+				GLClearError();
+
+			glUniform1i(location, 0);
+
+			if (check == 3 || (check == 2 && i % GL_ERROR_SAMPLE_PERIOD == 0))
+				GLLogCall("glUniform1i", __FILE__, __LINE__);
+		}
+		glFinish();
+		double ms = NowMs() - start;
+
+		std::cout << mode << "\t" << ms << "\t" << ms * 1e6 / callCount << std::endl;
+	};
+
+	std::cout << "mode\ttotal ms\tns/call" << std::endl;
+	run("off", 0);
+	if (debugOutput)
+		run("debug output", 1);
+	run("sampled", 2);
+	run("every call", 3);
+
+	if (debugOutput)
+		glEnable(GL_DEBUG_OUTPUT);
+
+	/* The raw glUniform1i calls went around the shader's shadow copy */
+	shader.InvalidateUniforms();
+}
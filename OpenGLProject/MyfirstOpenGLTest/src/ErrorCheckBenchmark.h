@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Shader.h"
+
+/*
+ * Times callCount glUniform1i calls under each error checking mode: nothing,
+ * KHR_debug output only, glGetError every GL_ERROR_SAMPLE_PERIOD calls and
+ * glGetError around every call. The modes are spelled out by hand because
+ * GLCall is fixed at compile time.
+ */
+void RunErrorCheckBenchmark(Shader& shader, unsigned int callCount = 200000);
\ No newline at end of file
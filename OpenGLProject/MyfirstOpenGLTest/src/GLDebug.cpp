@@ -0,0 +1,165 @@
+#include "GLDebug.h"
+
+#include <iostream>
+
+#include "Renderer.h"
+
+static const char* SourceName(unsigned int source)
+{
+	switch (source)
+	{
+	case GL_DEBUG_SOURCE_API:				return "API";
+	case GL_DEBUG_SOURCE_WINDOW_SYSTEM:	return "Window System";
+	case GL_DEBUG_SOURCE_SHADER_COMPILER:	return "Shader Compiler";
+	case GL_DEBUG_SOURCE_THIRD_PARTY:		return "Third Party";
+	case GL_DEBUG_SOURCE_APPLICATION:		return "Application";
+	}
+
+	return "Other";
+}
+
+static const char* TypeName(unsigned int type)
+{
+	switch (type)
+	{
+	case GL_DEBUG_TYPE_ERROR:					return "Error";
+	case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:	return "Deprecated";
+	case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:	return "Undefined Behavior";
+	case GL_DEBUG_TYPE_PORTABILITY:			return "Portability";
+	case GL_DEBUG_TYPE_PERFORMANCE:			return "Performance";
+	case GL_DEBUG_TYPE_MARKER:					return "Marker";
+	}
+
+	return "Other";
+}
+
+static const char* SeverityName(unsigned int severity)
+{
+	switch (severity)
+	{
+	case GL_DEBUG_SEVERITY_HIGH:		return "High";
+	case GL_DEBUG_SEVERITY_MEDIUM:	return "Medium";
+	case GL_DEBUG_SEVERITY_LOW:		return "Low";
+	}
+
+	return "Notification";
+}
+
+GLDebug& GLDebug::Get()
+{
+	static GLDebug s_Debug;
+	return s_Debug;
+}
+
+GLDebug::GLDebug()
+	: m_Enabled(false), m_Messages(0), m_Suppressed(0)
+{
+}
+
+bool GLDebug::Init(Severity minimumSeverity /*= Severity::Low*/, bool synchronous /*= false*/)
+{
+	if (!GLEW_VERSION_4_3 && !GLEW_KHR_debug)
+		return false;
+
+	GLCall(glEnable(GL_DEBUG_OUTPUT));
+	if (synchronous)
+	{
+		GLCall(glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS));
+	}
+	GLCall(glDebugMessageCallback((GLDEBUGPROC)&GLDebug::Callback, this));
+
+	/* Filter in the driver rather than in the callback */
+	static const unsigned int severities[] = {
+		GL_DEBUG_SEVERITY_NOTIFICATION, GL_DEBUG_SEVERITY_LOW, GL_DEBUG_SEVERITY_MEDIUM, GL_DEBUG_SEVERITY_HIGH
+	};
+	for (int i = 0; i < 4; i++)
+	{
+		GLboolean enabled = i >= (int)minimumSeverity ? GL_TRUE : GL_FALSE;
+		GLCall(glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, severities[i], 0, nullptr, enabled));
+	}
+
+	m_Enabled = true;
+	return true;
+}
+
+void GLDebug::Ignore(unsigned int id)
+{
+	if (!m_Enabled)
+		return;
+
+	GLCall(glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 1, &id, GL_FALSE));
+}
+
+void GLDebug::Label(unsigned int identifier, unsigned int name, const std::string& label) const
+{
+	if (!m_Enabled)
+		return;
+
+	GLCall(glObjectLabel(identifier, name, (int)label.size(), label.c_str()));
+}
+
+void GLDebug::PushGroup(const char* name) const
+{
+	if (!m_Enabled)
+		return;
+
+	GLCall(glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name));
+}
+
+void GLDebug::PopGroup() const
+{
+	if (!m_Enabled)
+		return;
+
+	GLCall(glPopDebugGroup());
+}
+
+unsigned int GLDebug::GetMessageCount()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Messages;
+}
+
+unsigned int GLDebug::GetSuppressedCount()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Suppressed;
+}
+
+void GLDebug::OnMessage(unsigned int source, unsigned int type, unsigned int id, unsigned int severity, const char* message)
+{
+	/* Sources and types are GL enums below 0x10000, ids are the driver's 32 bit message ids */
+	uint64_t key = (uint64_t)(source & 0xFFFF) << 48 | (uint64_t)(type & 0xFFFF) << 32 | id;
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Messages++;
+
+	/* Drivers repeat the same warning every frame, print only the first one */
+	auto it = m_Seen.find(key);
+	if (it != m_Seen.end())
+	{
+		it->second++;
+		m_Suppressed++;
+		return;
+	}
+
+	if (m_Seen.size() < MaxSeen)
+	{
+		m_Seen.emplace(key, 1);
+	}
+
+	std::cout << "[OpenGL_Debug] (" << id << ") " << SourceName(source) << " " << TypeName(type)
+		<< " [" << SeverityName(severity) << "] : " << message << "\n";
+
+	if (type == GL_DEBUG_TYPE_ERROR && severity == GL_DEBUG_SEVERITY_HIGH)
+	{
+		std::cout.flush();
+	}
+}
+
+void GLAPIENTRY GLDebug::Callback(unsigned int source, unsigned int type, unsigned int id, unsigned int severity,
+	int length, const char* message, const void* userParam)
+{
+	(void)length;
+	((GLDebug*)userParam)->OnMessage(source, type, id, severity, message);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/*
+ * KHR_debug message pipeline, the primary way GL errors are reported. The
+ * driver calls back on its own schedule (asynchronously unless Synchronous is
+ * requested), messages below the severity threshold or on the ignore list are
+ * filtered in the driver, and repeated messages are printed only once with a
+ * running count.
+ *
+ * Needs GL 4.3 or KHR_debug and, on most drivers, a context created with
+ * GLFW_OPENGL_DEBUG_CONTEXT. Without it every call here is a no-op.
+ */
+class GLDebug
+{
+public:
+	enum class Severity
+	{
+		Notification = 0, Low, Medium, High
+	};
+
+	/* Distinct messages remembered for duplicate suppression, later new ones are printed every time */
+	static const unsigned int MaxSeen = 1024;
+
+	static GLDebug& Get();
+
+	/* Synchronous makes the callback fire inside the offending call, for breakpoints */
+	bool Init(Severity minimumSeverity = Severity::Low, bool synchronous = false);
+	void Ignore(unsigned int id);
+
+	/* Names an object in debugger captures and in debug messages */
+	void Label(unsigned int identifier, unsigned int name, const std::string& label) const;
+	void PushGroup(const char* name) const;
+	void PopGroup() const;
+
+	inline bool IsEnabled() const { return m_Enabled; }
+	unsigned int GetMessageCount();
+	unsigned int GetSuppressedCount();
+private:
+	GLDebug();
+
+	void OnMessage(unsigned int source, unsigned int type, unsigned int id, unsigned int severity, const char* message);
+	static void GLAPIENTRY Callback(unsigned int source, unsigned int type, unsigned int id, unsigned int severity,
+		int length, const char* message, const void* userParam);
+private:
+	bool m_Enabled;
+
+	/* The callback may run on a driver thread */
+	std::mutex m_Mutex;
+	/* Times each message was seen, keyed on source, type and id packed together */
+	std::unordered_map<uint64_t, unsigned int> m_Seen;
+	unsigned int m_Messages;
+	unsigned int m_Suppressed;
+};
+
+/* Brackets the enclosing block in a debug group, e.g. one per render pass */
+class GLDebugGroup
+{
+public:
+	GLDebugGroup(const char* name)
+	{
+		GLDebug::Get().PushGroup(name);
+	}
+
+	~GLDebugGroup()
+	{
+		GLDebug::Get().PopGroup();
+	}
+};
\ No newline at end of file
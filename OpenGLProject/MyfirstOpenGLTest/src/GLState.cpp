@@ -0,0 +1,211 @@
+#include "GLState.h"
+
+#include "Renderer.h"
+
+/* Marks a bind point whose real value is not known */
+static const unsigned int Unknown = 0xffffffff;
+
+GLState& GLState::Get()
+{
+	static thread_local GLState s_State;
+	return s_State;
+}
+
+GLState::GLState()
+	: m_DirectStateAccessSupported(GLEW_VERSION_4_5 || GLEW_ARB_direct_state_access), m_DirectStateAccess(m_DirectStateAccessSupported)
+{
+	Invalidate();
+}
+
+void GLState::UseProgram(unsigned int program)
+{
+	if (m_Program == program)
+	{
+		m_Stats.Elided++;
+		return;
+	}
+
+	GLCall(glUseProgram(program));
+	m_Program = program;
+	m_Stats.Issued++;
+}
+
+void GLState::BindVertexArray(unsigned int vertexArray)
+{
+	if (m_VertexArray == vertexArray)
+	{
+		m_Stats.Elided++;
+		return;
+	}
+
+	GLCall(glBindVertexArray(vertexArray));
+	m_VertexArray = vertexArray;
+	m_Stats.Issued++;
+}
+
+void GLState::BindBuffer(unsigned int target, unsigned int buffer)
+{
+	if (target == GL_ELEMENT_ARRAY_BUFFER && m_VertexArray != Unknown)
+	{
+		auto it = m_ElementBuffers.find(m_VertexArray);
+		if (it != m_ElementBuffers.end() && it->second == buffer)
+		{
+			m_Stats.Elided++;
+			return;
+		}
+
+		GLCall(glBindBuffer(target, buffer));
+		if (it != m_ElementBuffers.end())
+			UnlinkElementBuffer(it->second, m_VertexArray);
+		m_ElementBuffers[m_VertexArray] = buffer;
+		if (buffer != 0)
+			m_VertexArraysByElementBuffer.emplace(buffer, m_VertexArray);
+		m_Stats.Issued++;
+		return;
+	}
+
+	int slot = GetBufferSlot(target);
+	if (slot >= 0 && m_Buffers[slot] == buffer)
+	{
+		m_Stats.Elided++;
+		return;
+	}
+
+	GLCall(glBindBuffer(target, buffer));
+	if (slot >= 0)
+		m_Buffers[slot] = buffer;
+	m_Stats.Issued++;
+}
+
+void GLState::ActiveTexture(unsigned int unit)
+{
+	if (m_ActiveTexture == unit)
+	{
+		m_Stats.Elided++;
+		return;
+	}
+
+	GLCall(glActiveTexture(GL_TEXTURE0 + unit));
+	m_ActiveTexture = unit;
+	m_Stats.Issued++;
+}
+
+void GLState::BindTexture(unsigned int target, unsigned int texture)
+{
+	/* Only GL_TEXTURE_2D is shadowed, other targets always go to the driver */
+	bool tracked = target == GL_TEXTURE_2D && m_ActiveTexture < MaxTextureUnits;
+	if (tracked && m_Textures[m_ActiveTexture] == texture)
+	{
+		m_Stats.Elided++;
+		return;
+	}
+
+	GLCall(glBindTexture(target, texture));
+	if (tracked)
+		m_Textures[m_ActiveTexture] = texture;
+	m_Stats.Issued++;
+}
+
+void GLState::BindTextureUnit(unsigned int unit, unsigned int target, unsigned int texture)
+{
+	/* Already bound on that unit: skip the glActiveTexture as well */
+	if (target == GL_TEXTURE_2D && unit < MaxTextureUnits && m_Textures[unit] == texture)
+	{
+		m_Stats.Elided++;
+		return;
+	}
+
+	/* glBindTextureUnit leaves the active unit alone */
+	if (m_DirectStateAccess)
+	{
+		GLCall(glBindTextureUnit(unit, texture));
+		if (target == GL_TEXTURE_2D && unit < MaxTextureUnits)
+			m_Textures[unit] = texture;
+		m_Stats.Issued++;
+		return;
+	}
+
+	ActiveTexture(unit);
+	BindTexture(target, texture);
+}
+
+void GLState::OnDeleteVertexArray(unsigned int vertexArray)
+{
+	auto it = m_ElementBuffers.find(vertexArray);
+	if (it != m_ElementBuffers.end())
+	{
+		UnlinkElementBuffer(it->second, vertexArray);
+		m_ElementBuffers.erase(it);
+	}
+	if (m_VertexArray == vertexArray)
+		m_VertexArray = 0;
+}
+
+void GLState::OnDeleteBuffer(unsigned int buffer)
+{
+	for (auto& bound : m_Buffers)
+	{
+		if (bound == buffer)
+			bound = 0;
+	}
+
+	/* Only the bound VAO drops its element binding, the others keep a name that may be reused */
+	auto range = m_VertexArraysByElementBuffer.equal_range(buffer);
+	for (auto it = range.first; it != range.second; ++it)
+		m_ElementBuffers[it->second] = it->second == m_VertexArray ? 0 : Unknown;
+	m_VertexArraysByElementBuffer.erase(range.first, range.second);
+}
+
+void GLState::OnDeleteTexture(unsigned int texture)
+{
+	for (auto& bound : m_Textures)
+	{
+		if (bound == texture)
+			bound = 0;
+	}
+}
+
+void GLState::Invalidate()
+{
+	m_Program = Unknown;
+	m_VertexArray = Unknown;
+	m_Buffers.fill(Unknown);
+	m_ElementBuffers.clear();
+	m_VertexArraysByElementBuffer.clear();
+	m_ActiveTexture = Unknown;
+	m_Textures.fill(Unknown);
+}
+
+void GLState::SetDirectStateAccess(bool enabled)
+{
+	m_DirectStateAccess = enabled && m_DirectStateAccessSupported;
+}
+
+void GLState::UnlinkElementBuffer(unsigned int buffer, unsigned int vertexArray)
+{
+	auto range = m_VertexArraysByElementBuffer.equal_range(buffer);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (it->second == vertexArray)
+		{
+			m_VertexArraysByElementBuffer.erase(it);
+			return;
+		}
+	}
+}
+
+int GLState::GetBufferSlot(unsigned int target) const
+{
+	switch (target)
+	{
+	case GL_ARRAY_BUFFER:				return ArrayBuffer;
+	case GL_UNIFORM_BUFFER:			return UniformBuffer;
+	case GL_DRAW_INDIRECT_BUFFER:	return DrawIndirectBuffer;
+	case GL_COPY_READ_BUFFER:		return CopyReadBuffer;
+	case GL_COPY_WRITE_BUFFER:		return CopyWriteBuffer;
+	case GL_PIXEL_UNPACK_BUFFER:	return PixelUnpackBuffer;
+	case GL_PIXEL_PACK_BUFFER:		return PixelPackBuffer;
+	}
+
+	return -1;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <unordered_map>
+
+/*
+ * Shadow copy of the bind points the wrappers touch. Every Bind()/UnBind()
+ * goes through here so binding an object that is already bound never reaches
+ * the driver. There is one instance per thread, which matches the GL rule that
+ * a context is current on a single thread at a time.
+ *
+ * Anything that binds behind the cache's back must call Invalidate().
+ */
+class GLState
+{
+public:
+	static const unsigned int MaxTextureUnits = 32;
+
+	struct Stats
+	{
+		unsigned int Issued = 0;
+		unsigned int Elided = 0;
+	};
+
+	static GLState& Get();
+
+	void UseProgram(unsigned int program);
+	void BindVertexArray(unsigned int vertexArray);
+	void BindBuffer(unsigned int target, unsigned int buffer);
+	void ActiveTexture(unsigned int unit);
+	/* Binds to the currently active texture unit */
+	void BindTexture(unsigned int target, unsigned int texture);
+	void BindTextureUnit(unsigned int unit, unsigned int target, unsigned int texture);
+
+	/* Deleting an object implicitly unbinds it, keep the shadow copy in sync */
+	void OnDeleteVertexArray(unsigned int vertexArray);
+	void OnDeleteBuffer(unsigned int buffer);
+	void OnDeleteTexture(unsigned int texture);
+
+	/* Forget everything, the next bind of each kind is always issued */
+	void Invalidate();
+
+	/*
+	 * GL 4.5 / ARB_direct_state_access: the wrappers create and edit objects
+	 * by name (glCreateBuffers, glNamedBufferStorage, glTextureStorage2D,
+	 * glVertexArrayAttribFormat, ...) instead of binding them first, so
+	 * creating or updating a resource leaves the bind points alone. On by
+	 * default when supported; turning it off selects the bind-to-edit path.
+	 */
+	inline bool UseDirectStateAccess() const { return m_DirectStateAccess; }
+	void SetDirectStateAccess(bool enabled);
+
+	inline const Stats& GetStats() const { return m_Stats; }
+	inline void ResetStats() { m_Stats = Stats(); }
+private:
+	GLState();
+
+	int GetBufferSlot(unsigned int target) const;
+	void UnlinkElementBuffer(unsigned int buffer, unsigned int vertexArray);
+private:
+	enum BufferSlot
+	{
+		ArrayBuffer = 0, UniformBuffer, DrawIndirectBuffer, CopyReadBuffer, CopyWriteBuffer,
+		PixelUnpackBuffer, PixelPackBuffer, BufferSlotCount
+	};
+
+	unsigned int m_Program;
+	unsigned int m_VertexArray;
+	std::array<unsigned int, BufferSlotCount> m_Buffers;
+	/* GL_ELEMENT_ARRAY_BUFFER is part of the VAO state, so it is tracked per VAO */
+	std::unordered_map<unsigned int, unsigned int> m_ElementBuffers;
+	/* The reverse of m_ElementBuffers, so deleting a buffer only visits the VAOs holding it */
+	std::unordered_multimap<unsigned int, unsigned int> m_VertexArraysByElementBuffer;
+	unsigned int m_ActiveTexture;
+	std::array<unsigned int, MaxTextureUnits> m_Textures;
+
+	/* Queried on first use, so it must not be constructed before glewInit */
+	bool m_DirectStateAccessSupported;
+	bool m_DirectStateAccess;
+
+	Stats m_Stats;
+};
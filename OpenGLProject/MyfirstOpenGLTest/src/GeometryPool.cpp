@@ -0,0 +1,266 @@
+#include "GeometryPool.h"
+
+#include <algorithm>
+
+RangeAllocator::RangeAllocator(unsigned int capacity)
+	: m_Capacity(capacity), m_Used(0)
+{
+	InsertFree(0, capacity);
+}
+
+unsigned int RangeAllocator::Allocate(unsigned int size)
+{
+	auto fit = m_FreeBySize.lower_bound(size);
+	if (fit == m_FreeBySize.end())
+		return Invalid;
+
+	unsigned int offset = fit->second;
+	unsigned int blockSize = fit->first;
+	EraseFree(m_FreeByOffset.find(offset));
+
+	/* Keep the tail of the block free */
+	if (blockSize > size)
+		InsertFree(offset + size, blockSize - size);
+
+	m_Used += size;
+	return offset;
+}
+
+void RangeAllocator::Free(unsigned int offset, unsigned int size)
+{
+	ASSERT(offset + size <= m_Capacity && size <= m_Used);
+	m_Used -= size;
+
+	/* Merge with the free blocks directly before and after */
+	auto next = m_FreeByOffset.lower_bound(offset);
+	if (next != m_FreeByOffset.begin())
+	{
+		auto previous = std::prev(next);
+		if (previous->first + previous->second == offset)
+		{
+			offset = previous->first;
+			size += previous->second;
+			EraseFree(previous);
+		}
+	}
+
+	if (next != m_FreeByOffset.end() && offset + size == next->first)
+	{
+		size += next->second;
+		EraseFree(next);
+	}
+
+	InsertFree(offset, size);
+}
+
+void RangeAllocator::Reset(unsigned int used)
+{
+	ASSERT(used <= m_Capacity);
+
+	m_FreeByOffset.clear();
+	m_FreeBySize.clear();
+	m_Used = used;
+	if (used < m_Capacity)
+		InsertFree(used, m_Capacity - used);
+}
+
+unsigned int RangeAllocator::GetLargestFree() const
+{
+	return m_FreeBySize.empty() ? 0 : m_FreeBySize.rbegin()->first;
+}
+
+bool RangeAllocator::IsCompact() const
+{
+	/* At most one free block, and it is the tail */
+	return m_FreeByOffset.empty() || (m_FreeByOffset.size() == 1 && m_FreeByOffset.begin()->first == m_Used);
+}
+
+float RangeAllocator::GetFragmentation() const
+{
+	unsigned int free = m_Capacity - m_Used;
+	return free ? 1.0f - (float)GetLargestFree() / free : 0.0f;
+}
+
+void RangeAllocator::InsertFree(unsigned int offset, unsigned int size)
+{
+	m_FreeByOffset[offset] = size;
+	m_FreeBySize.insert({ size, offset });
+}
+
+void RangeAllocator::EraseFree(std::map<unsigned int, unsigned int>::iterator block)
+{
+	auto sized = m_FreeBySize.equal_range(block->second);
+	for (auto it = sized.first; it != sized.second; ++it)
+	{
+		if (it->second == block->first)
+		{
+			m_FreeBySize.erase(it);
+			break;
+		}
+	}
+	m_FreeByOffset.erase(block);
+}
+
+GeometryPool::GeometryPool(const VertexBufferLayout& layout, unsigned int verticesPerPage /*= 1 << 16*/, unsigned int indicesPerPage /*= 1 << 18*/)
+	: m_Layout(layout), m_VerticesPerPage(verticesPerPage), m_IndicesPerPage(indicesPerPage)
+{
+}
+
+GeometryPool::~GeometryPool()
+{
+}
+
+unsigned int GeometryPool::Add(const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount)
+{
+	ASSERT(vertexCount > 0 && indexCount > 0 && vertexCount <= m_VerticesPerPage && indexCount <= m_IndicesPerPage);
+
+	Mesh mesh = { 0, 0, 0, vertexCount, indexCount };
+	unsigned int baseVertex = RangeAllocator::Invalid;
+	unsigned int firstIndex = RangeAllocator::Invalid;
+
+	for (unsigned int i = 0; i <= m_Pages.size(); i++)
+	{
+		if (i == m_Pages.size())
+			OpenPage();
+
+		Page& page = *m_Pages[i];
+		baseVertex = page.VertexRanges.Allocate(vertexCount);
+		if (baseVertex == RangeAllocator::Invalid)
+			continue;
+
+		firstIndex = page.IndexRanges.Allocate(indexCount);
+		if (firstIndex == RangeAllocator::Invalid)
+		{
+			page.VertexRanges.Free(baseVertex, vertexCount);
+			continue;
+		}
+
+		mesh.Page = i;
+		break;
+	}
+
+	mesh.BaseVertex = (int)baseVertex;
+	mesh.FirstIndex = firstIndex;
+
+	unsigned int stride = m_Layout.GetStride();
+	Page& page = *m_Pages[mesh.Page];
+	page.Vertices->Update(baseVertex * stride, vertices, vertexCount * stride);
+	page.Indices->UpdateIndices(firstIndex, indices, indexCount);
+
+	if (!m_FreeMeshes.empty())
+	{
+		unsigned int id = m_FreeMeshes.back();
+		m_FreeMeshes.pop_back();
+		m_Meshes[id] = mesh;
+		return id;
+	}
+
+	m_Meshes.push_back(mesh);
+	return (unsigned int)m_Meshes.size() - 1;
+}
+
+void GeometryPool::Remove(unsigned int mesh)
+{
+	Mesh& record = m_Meshes[mesh];
+	ASSERT(record.IndexCount > 0);
+
+	Page& page = *m_Pages[record.Page];
+	page.VertexRanges.Free((unsigned int)record.BaseVertex, record.VertexCount);
+	page.IndexRanges.Free(record.FirstIndex, record.IndexCount);
+
+	/* A zero index count marks the id as free */
+	record = { 0, 0, 0, 0, 0 };
+	m_FreeMeshes.push_back(mesh);
+}
+
+void GeometryPool::Defragment()
+{
+	unsigned int stride = m_Layout.GetStride();
+
+	for (unsigned int p = 0; p < m_Pages.size(); p++)
+	{
+		Page& page = *m_Pages[p];
+		if (page.VertexRanges.IsCompact() && page.IndexRanges.IsCompact())
+			continue;
+
+		std::vector<unsigned int> meshes;
+		for (unsigned int id = 0; id < m_Meshes.size(); id++)
+		{
+			if (m_Meshes[id].IndexCount > 0 && m_Meshes[id].Page == p)
+				meshes.push_back(id);
+		}
+
+		/* Ranges may overlap their new position, so copy into fresh buffers instead of in place */
+		std::unique_ptr<VertexBuffer> oldVertices = std::move(page.Vertices);
+		std::unique_ptr<IndexBuffer> oldIndices = std::move(page.Indices);
+		CreateBuffers(page);
+
+		/* Keep the meshes in their current order so neighbours stay neighbours */
+		std::sort(meshes.begin(), meshes.end(), [this](unsigned int a, unsigned int b) { return m_Meshes[a].BaseVertex < m_Meshes[b].BaseVertex; });
+
+		GLState::Get().BindBuffer(GL_COPY_READ_BUFFER, oldVertices->GetRendererID());
+		GLState::Get().BindBuffer(GL_COPY_WRITE_BUFFER, page.Vertices->GetRendererID());
+		unsigned int vertex = 0;
+		for (unsigned int id : meshes)
+		{
+			Mesh& mesh = m_Meshes[id];
+			GLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, mesh.BaseVertex * stride, vertex * stride, mesh.VertexCount * stride));
+			mesh.BaseVertex = (int)vertex;
+			vertex += mesh.VertexCount;
+		}
+
+		std::sort(meshes.begin(), meshes.end(), [this](unsigned int a, unsigned int b) { return m_Meshes[a].FirstIndex < m_Meshes[b].FirstIndex; });
+
+		GLState::Get().BindBuffer(GL_COPY_READ_BUFFER, oldIndices->GetRendererID());
+		GLState::Get().BindBuffer(GL_COPY_WRITE_BUFFER, page.Indices->GetRendererID());
+		unsigned int indexSize = page.Indices->GetIndexSize();
+		unsigned int index = 0;
+		for (unsigned int id : meshes)
+		{
+			Mesh& mesh = m_Meshes[id];
+			GLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, mesh.FirstIndex * indexSize, index * indexSize, mesh.IndexCount * indexSize));
+			mesh.FirstIndex = index;
+			index += mesh.IndexCount;
+		}
+
+		page.VertexRanges.Reset(vertex);
+		page.IndexRanges.Reset(index);
+	}
+}
+
+GeometryPool::Stats GeometryPool::GetStats() const
+{
+	Stats stats;
+	stats.Pages = (unsigned int)m_Pages.size();
+	stats.Meshes = (unsigned int)(m_Meshes.size() - m_FreeMeshes.size());
+
+	for (const auto& page : m_Pages)
+	{
+		stats.VertexCapacity += page->VertexRanges.GetCapacity();
+		stats.VerticesUsed += page->VertexRanges.GetUsed();
+		stats.IndexCapacity += page->IndexRanges.GetCapacity();
+		stats.IndicesUsed += page->IndexRanges.GetUsed();
+		stats.VertexFragmentation = std::max(stats.VertexFragmentation, page->VertexRanges.GetFragmentation());
+		stats.IndexFragmentation = std::max(stats.IndexFragmentation, page->IndexRanges.GetFragmentation());
+	}
+
+	return stats;
+}
+
+void GeometryPool::CreateBuffers(Page& page)
+{
+	page.VertexArr = std::make_unique<VertexArray>();
+	page.Vertices = std::make_unique<VertexBuffer>(nullptr, m_VerticesPerPage * m_Layout.GetStride());
+	page.VertexArr->Addbuffer(*page.Vertices, m_Layout);
+
+	/* Mesh-relative indices stay below the page's vertex count; Renderer::Draw binds it to the page's VAO */
+	page.Indices = std::make_unique<IndexBuffer>(m_IndicesPerPage, IndexBuffer::GetTypeFor(m_VerticesPerPage - 1), BufferUsage::Static);
+	page.VertexArr->UnBind();
+}
+
+unsigned int GeometryPool::OpenPage()
+{
+	m_Pages.push_back(std::make_unique<Page>(m_VerticesPerPage, m_IndicesPerPage));
+	CreateBuffers(*m_Pages.back());
+	return (unsigned int)m_Pages.size() - 1;
+}
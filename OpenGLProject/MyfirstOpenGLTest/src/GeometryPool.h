@@ -0,0 +1,126 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "VertexBufferLayout.h"
+
+/*
+ * Best-fit free list over [0, capacity). Free blocks are indexed both by
+ * offset, to merge a freed block with its neighbours, and by size, to find
+ * the smallest block an allocation fits in.
+ */
+class RangeAllocator
+{
+public:
+	static const unsigned int Invalid = 0xffffffff;
+
+	RangeAllocator(unsigned int capacity);
+
+	/* Returns the offset of the range or Invalid */
+	unsigned int Allocate(unsigned int size);
+	void Free(unsigned int offset, unsigned int size);
+	/* Marks [0, used) allocated and the rest free, used after compaction */
+	void Reset(unsigned int used);
+
+	inline unsigned int GetCapacity() const { return m_Capacity; }
+	inline unsigned int GetUsed() const { return m_Used; }
+	inline unsigned int GetFreeBlockCount() const { return (unsigned int)m_FreeByOffset.size(); }
+	unsigned int GetLargestFree() const;
+	/* Everything allocated sits in [0, GetUsed()) */
+	bool IsCompact() const;
+	/* 0 when all free space is one block, towards 1 as it splinters */
+	float GetFragmentation() const;
+private:
+	void InsertFree(unsigned int offset, unsigned int size);
+	void EraseFree(std::map<unsigned int, unsigned int>::iterator block);
+private:
+	unsigned int m_Capacity;
+	unsigned int m_Used;
+	std::map<unsigned int, unsigned int> m_FreeByOffset;
+	std::multimap<unsigned int, unsigned int> m_FreeBySize;
+};
+
+/*
+ * Sub-allocates meshes of one vertex layout out of a few large vertex and
+ * index buffers ("pages"). Every page has a single VAO, and a mesh is drawn
+ * with glDrawElementsBaseVertex from its vertex and index ranges, so drawing
+ * many pooled meshes only rebinds when the page changes. Indices stay
+ * relative to the mesh, so ranges can move without rewriting them.
+ *
+ * Meshes are referred to by id; Defragment() may move their ranges.
+ */
+class GeometryPool
+{
+public:
+	static const unsigned int InvalidMesh = 0xffffffff;
+
+	struct Mesh
+	{
+		unsigned int Page;
+		int BaseVertex;
+		unsigned int FirstIndex;
+		unsigned int VertexCount;
+		unsigned int IndexCount;
+	};
+
+	struct Stats
+	{
+		unsigned int Pages = 0;
+		unsigned int Meshes = 0;
+		unsigned int VertexCapacity = 0;
+		unsigned int VerticesUsed = 0;
+		unsigned int IndexCapacity = 0;
+		unsigned int IndicesUsed = 0;
+		/* Worst page, see RangeAllocator::GetFragmentation */
+		float VertexFragmentation = 0.0f;
+		float IndexFragmentation = 0.0f;
+
+		inline float GetVertexOccupancy() const { return VertexCapacity ? (float)VerticesUsed / VertexCapacity : 0.0f; }
+		inline float GetIndexOccupancy() const { return IndexCapacity ? (float)IndicesUsed / IndexCapacity : 0.0f; }
+	};
+
+	GeometryPool(const VertexBufferLayout& layout, unsigned int verticesPerPage = 1 << 16, unsigned int indicesPerPage = 1 << 18);
+	~GeometryPool();
+
+	/* Copies the mesh into the first page with room, opening a new page if none has; meshes must not be empty */
+	unsigned int Add(const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount);
+	void Remove(unsigned int mesh);
+
+	/* Compacts every fragmented page by copying its meshes, in order, into fresh buffers */
+	void Defragment();
+
+	inline const Mesh& GetMesh(unsigned int mesh) const { return m_Meshes[mesh]; }
+	inline const VertexArray& GetVertexArray(unsigned int page) const { return *m_Pages[page]->VertexArr; }
+	inline IndexBuffer& GetIndexBuffer(unsigned int page) const { return *m_Pages[page]->Indices; }
+	inline unsigned int GetPageCount() const { return (unsigned int)m_Pages.size(); }
+
+	Stats GetStats() const;
+private:
+	struct Page
+	{
+		std::unique_ptr<VertexArray> VertexArr;
+		std::unique_ptr<VertexBuffer> Vertices;
+		std::unique_ptr<IndexBuffer> Indices;
+		RangeAllocator VertexRanges;
+		RangeAllocator IndexRanges;
+
+		Page(unsigned int vertexCapacity, unsigned int indexCapacity)
+			: VertexRanges(vertexCapacity), IndexRanges(indexCapacity) {}
+	};
+
+	void CreateBuffers(Page& page);
+	unsigned int OpenPage();
+private:
+	VertexBufferLayout m_Layout;
+	unsigned int m_VerticesPerPage;
+	unsigned int m_IndicesPerPage;
+
+	std::vector<std::unique_ptr<Page>> m_Pages;
+	std::vector<Mesh> m_Meshes;
+	std::vector<unsigned int> m_FreeMeshes;
+};
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include "GpuProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "Renderer.h"
+
+static double NowMs()
+{
+	using namespace std::chrono;
+	return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+/* Zone id of the frame scope, which is reported through FrameStats instead */
+static const unsigned int FrameZone = ~0u;
+
+static const unsigned int PipelineTargets[3] = {
+	GL_VERTICES_SUBMITTED_ARB, GL_PRIMITIVES_SUBMITTED_ARB, GL_FRAGMENT_SHADER_INVOCATIONS_ARB
+};
+
+GpuProfiler::GpuProfiler(unsigned int window /*= 120*/)
+	: m_Window(window), m_FrameIndex(0), m_FrameStart(0.0), m_DroppedFrames(0)
+{
+	m_TimerQueries = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+	m_PipelineQueries = GLEW_ARB_pipeline_statistics_query != GL_FALSE;
+
+	if (m_PipelineQueries)
+	{
+		for (auto& frame : m_Frames)
+		{
+			GLCall(glGenQueries(3, frame.PipelineQueries));
+		}
+	}
+}
+
+GpuProfiler::~GpuProfiler()
+{
+	for (auto& frame : m_Frames)
+	{
+		if (!frame.Queries.empty())
+		{
+			GLCall(glDeleteQueries((int)frame.Queries.size(), frame.Queries.data()));
+		}
+		if (m_PipelineQueries)
+		{
+			GLCall(glDeleteQueries(3, frame.PipelineQueries));
+		}
+	}
+}
+
+void GpuProfiler::BeginFrame()
+{
+	if (!m_TimerQueries)
+		return;
+
+	Frame& frame = m_Frames[m_FrameIndex];
+	frame.Used = 0;
+	frame.Scopes.clear();
+	m_OpenScopes.clear();
+
+	/* Frame begin/end are the first scope, so the GPU frame time comes out the same way */
+	frame.Scopes.push_back({ FrameZone, Stamp(frame), 0 });
+
+	if (m_PipelineQueries)
+	{
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			GLCall(glBeginQuery(PipelineTargets[i], frame.PipelineQueries[i]));
+		}
+	}
+
+	m_FrameStart = NowMs();
+}
+
+void GpuProfiler::EndFrame()
+{
+	if (!m_TimerQueries)
+		return;
+
+	Frame& frame = m_Frames[m_FrameIndex];
+	frame.CpuMs = NowMs() - m_FrameStart;
+
+	if (m_PipelineQueries)
+	{
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			GLCall(glEndQuery(PipelineTargets[i]));
+		}
+	}
+
+	frame.Scopes[0].End = Stamp(frame);
+	frame.Pending = true;
+
+	/* The next slot was issued FrameLatency frames ago, read it back before reusing it */
+	m_FrameIndex = (m_FrameIndex + 1) % (FrameLatency + 1);
+	Frame& oldest = m_Frames[m_FrameIndex];
+	if (oldest.Pending)
+		Collect(oldest);
+}
+
+void GpuProfiler::BeginScope(const char* name)
+{
+	if (!m_TimerQueries)
+		return;
+
+	Frame& frame = m_Frames[m_FrameIndex];
+	m_OpenScopes.push_back((unsigned int)frame.Scopes.size());
+	frame.Scopes.push_back({ GetZoneID(name), Stamp(frame), 0 });
+}
+
+void GpuProfiler::EndScope()
+{
+	if (!m_TimerQueries || m_OpenScopes.empty())
+		return;
+
+	Frame& frame = m_Frames[m_FrameIndex];
+	frame.Scopes[m_OpenScopes.back()].End = Stamp(frame);
+	m_OpenScopes.pop_back();
+}
+
+unsigned int GpuProfiler::Stamp(Frame& frame)
+{
+	if (frame.Used == frame.Queries.size())
+	{
+		unsigned int query;
+		GLCall(glGenQueries(1, &query));
+		frame.Queries.push_back(query);
+	}
+
+	unsigned int index = frame.Used++;
+	GLCall(glQueryCounter(frame.Queries[index], GL_TIMESTAMP));
+	return index;
+}
+
+void GpuProfiler::Collect(Frame& frame)
+{
+	frame.Pending = false;
+
+	/* Queries complete in order, if the last one is ready they all are */
+	int available = 0;
+	GLCall(glGetQueryObjectiv(frame.Queries[frame.Scopes[0].End], GL_QUERY_RESULT_AVAILABLE, &available));
+	if (!available)
+	{
+		m_DroppedFrames++;
+		return;
+	}
+
+	std::vector<uint64_t> timestamps(frame.Used);
+	for (unsigned int i = 0; i < frame.Used; i++)
+	{
+		GLCall(glGetQueryObjectui64v(frame.Queries[i], GL_QUERY_RESULT, &timestamps[i]));
+	}
+
+	for (unsigned int i = 1; i < frame.Scopes.size(); i++)
+	{
+		const Scope& scope = frame.Scopes[i];
+		AddSample(scope.Zone, (timestamps[scope.End] - timestamps[scope.Begin]) / 1e6);
+	}
+
+	FrameStats stats;
+	stats.CpuMs = frame.CpuMs;
+	stats.GpuMs = (timestamps[frame.Scopes[0].End] - timestamps[frame.Scopes[0].Begin]) / 1e6;
+	stats.GpuBound = stats.GpuMs > stats.CpuMs;
+
+	/* The statistics queries end before the last timestamp but are not ordered with it, check each one */
+	if (m_PipelineQueries)
+	{
+		uint64_t* counters[3] = { &stats.VerticesSubmitted, &stats.PrimitivesSubmitted, &stats.FragmentInvocations };
+		const uint64_t last[3] = { m_LastFrame.VerticesSubmitted, m_LastFrame.PrimitivesSubmitted, m_LastFrame.FragmentInvocations };
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			GLCall(glGetQueryObjectiv(frame.PipelineQueries[i], GL_QUERY_RESULT_AVAILABLE, &available));
+			if (available)
+			{
+				GLCall(glGetQueryObjectui64v(frame.PipelineQueries[i], GL_QUERY_RESULT, counters[i]));
+			}
+			else
+			{
+				/* Not ready yet, keep the last value read rather than stall */
+				*counters[i] = last[i];
+			}
+		}
+	}
+
+	m_LastFrame = stats;
+}
+
+unsigned int GpuProfiler::GetZoneID(const char* name)
+{
+	auto it = m_ZoneIDs.find(name);
+	if (it != m_ZoneIDs.end())
+		return it->second;
+
+	/* The same name can live at another address in another translation unit */
+	unsigned int id = 0;
+	while (id < m_Zones.size() && m_Zones[id].Name != name)
+		id++;
+
+	if (id == m_Zones.size())
+	{
+		m_Zones.emplace_back();
+		m_Zones.back().Name = name;
+	}
+
+	m_ZoneIDs.emplace(name, id);
+	return id;
+}
+
+void GpuProfiler::AddSample(unsigned int zone, double ms)
+{
+	std::deque<double>& samples = m_Zones[zone].Samples;
+	samples.push_back(ms);
+	if (samples.size() > m_Window)
+		samples.pop_front();
+}
+
+GpuProfiler::ScopeStats GpuProfiler::GetScopeStats(const std::string& name) const
+{
+	ScopeStats stats;
+
+	auto it = std::find_if(m_Zones.begin(), m_Zones.end(), [&name](const Zone& zone) { return zone.Name == name; });
+	if (it == m_Zones.end() || it->Samples.empty())
+		return stats;
+
+	std::vector<double> sorted(it->Samples.begin(), it->Samples.end());
+	std::sort(sorted.begin(), sorted.end());
+
+	double total = 0.0;
+	for (double ms : sorted)
+		total += ms;
+
+	stats.Samples = (unsigned int)sorted.size();
+	stats.MinMs = sorted.front();
+	stats.MaxMs = sorted.back();
+	stats.AvgMs = total / sorted.size();
+	stats.P99Ms = sorted[std::min((size_t)(sorted.size() * 0.99), sorted.size() - 1)];
+	return stats;
+}
+
+std::vector<std::string> GpuProfiler::GetScopeNames() const
+{
+	std::vector<std::string> names;
+	for (const Zone& zone : m_Zones)
+		names.push_back(zone.Name);
+
+	std::sort(names.begin(), names.end());
+	return names;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * GPU timings per named scope from GL_TIMESTAMP queries. Every frame uses its
+ * own set of query objects out of a ring of FrameLatency + 1 sets, and a set
+ * is only read back when the ring wraps around to it, FrameLatency frames
+ * later. By then the GPU is normally done; if it is not, that frame's results
+ * are dropped instead of waiting for them.
+ *
+ * Scopes can nest because each one is a pair of timestamps rather than a
+ * GL_TIME_ELAPSED query. Where ARB_pipeline_statistics_query is available the
+ * frame is also wrapped in vertex, primitive and fragment invocation queries.
+ */
+class GpuProfiler
+{
+public:
+	static const unsigned int FrameLatency = 3;
+
+	struct ScopeStats
+	{
+		unsigned int Samples = 0;
+		double MinMs = 0.0;
+		double AvgMs = 0.0;
+		double MaxMs = 0.0;
+		double P99Ms = 0.0;
+	};
+
+	struct FrameStats
+	{
+		/* CPU time between BeginFrame and EndFrame, and GPU time for the same commands */
+		double CpuMs = 0.0;
+		double GpuMs = 0.0;
+		bool GpuBound = false;
+		uint64_t VerticesSubmitted = 0;
+		uint64_t PrimitivesSubmitted = 0;
+		uint64_t FragmentInvocations = 0;
+	};
+
+	GpuProfiler(unsigned int window = 120);
+	~GpuProfiler();
+
+	void BeginFrame();
+	void EndFrame();
+
+	/* Scopes are expected to use string literals, each name is looked up by its address */
+	void BeginScope(const char* name);
+	void EndScope();
+
+	ScopeStats GetScopeStats(const std::string& name) const;
+	std::vector<std::string> GetScopeNames() const;
+
+	/* The most recent frame whose results have been read back */
+	inline const FrameStats& GetLastFrame() const { return m_LastFrame; }
+	inline unsigned int GetDroppedFrames() const { return m_DroppedFrames; }
+	inline bool IsSupported() const { return m_TimerQueries; }
+private:
+	struct Scope
+	{
+		unsigned int Zone;
+		unsigned int Begin;
+		unsigned int End;
+	};
+
+	struct Zone
+	{
+		std::string Name;
+		std::deque<double> Samples;
+	};
+
+	struct Frame
+	{
+		std::vector<unsigned int> Queries;
+		unsigned int Used = 0;
+		std::vector<Scope> Scopes;
+		unsigned int PipelineQueries[3] = {};
+		double CpuMs = 0.0;
+		bool Pending = false;
+	};
+
+	unsigned int Stamp(Frame& frame);
+	void Collect(Frame& frame);
+	unsigned int GetZoneID(const char* name);
+	void AddSample(unsigned int zone, double ms);
+private:
+	bool m_TimerQueries;
+	bool m_PipelineQueries;
+	unsigned int m_Window;
+
+	Frame m_Frames[FrameLatency + 1];
+	unsigned int m_FrameIndex;
+	/* Indices into the current frame's Scopes of the scopes not closed yet */
+	std::vector<unsigned int> m_OpenScopes;
+	double m_FrameStart;
+
+	/* Zones are indexed by id; ids are found by name address, so only a new address compares strings */
+	std::vector<Zone> m_Zones;
+	std::unordered_map<const char*, unsigned int> m_ZoneIDs;
+	FrameStats m_LastFrame;
+	unsigned int m_DroppedFrames;
+};
+
+/* Times the enclosing block on the GPU */
+class GpuScope
+{
+private:
+	GpuProfiler& m_Profiler;
+public:
+	GpuScope(GpuProfiler& profiler, const char* name)
+		: m_Profiler(profiler)
+	{
+		m_Profiler.BeginScope(name);
+	}
+
+	~GpuScope()
+	{
+		m_Profiler.EndScope();
+	}
+};
\ No newline at end of file
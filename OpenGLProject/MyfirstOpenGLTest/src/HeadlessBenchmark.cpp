@@ -0,0 +1,829 @@
+/*
+ * Headless renderer benchmark. Creates a context through HeadlessContext,
+ * renders each scene for a fixed number of frames and writes frame time
+ * percentiles, draw counts and upload volume as JSON.
+ *
+ *   HeadlessBenchmark [--scene all|immediate|vaocache|queue|materials|batch|instanced|animated|pool|lod|mesh|quantized]
+ *                     [--count N]
+ *                     [--frames N] [--warmup N] [--width W] [--height H]
+ *                     [--dsa 0|1] [--output file.json]
+ *
+ * --dsa 0 forces the bind-to-edit path on a context with direct state access;
+ * the GL calls made creating each scene and per frame are reported for both,
+ * with the uniform uploads issued and skipped by the shaders' shadow state.
+ * The cost of one PROFILE_SCOPE zone is measured once and reported alongside.
+ *
+ * Run it from the project directory so res/ is found.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "HeadlessContext.h"
+#include "Renderer.h"
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "IndexBuffer.h"
+#include "VertexArray.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "BatchRenderer.h"
+#include "RenderQueue.h"
+#include "GeometryPool.h"
+#include "LodChain.h"
+#include "VertexQuantizer.h"
+#include "SphereMesh.h"
+#include "VertexArrayCache.h"
+#include "Profiler.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+static double NowMs()
+{
+	using namespace std::chrono;
+	return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+static const float s_QuadVertices[] = {
+	-0.5f, -0.5f, 0.0f, 0.0f,
+	 0.5f, -0.5f, 1.0f, 0.0f,
+	 0.5f,  0.5f, 1.0f, 1.0f,
+	-0.5f,  0.5f, 0.0f, 1.0f
+};
+
+static const unsigned int s_QuadIndices[] = {
+	0, 1, 2,
+	2, 3, 0
+};
+
+/* Lays count quads out on a square grid covering the [-1, 1] clip square */
+struct Grid
+{
+	unsigned int Side;
+	float Cell;
+
+	Grid(unsigned int count)
+	{
+		Side = 1;
+		while (Side * Side < count)
+			Side++;
+		Cell = 2.0f / Side;
+	}
+
+	inline glm::vec2 Position(unsigned int i) const
+	{
+		return { -1.0f + (i % Side + 0.5f) * Cell, -1.0f + (i / Side + 0.5f) * Cell };
+	}
+};
+
+constexpr auto SphereVertexLayout = MakeVertexLayout<SphereVertex>(
+	VERTEX_ATTRIBUTE(SphereVertex, Position),
+	VERTEX_ATTRIBUTE(SphereVertex, TexCoord),
+	VERTEX_ATTRIBUTE(SphereVertex, Normal));
+
+class Scene
+{
+public:
+	virtual ~Scene() {}
+
+	virtual void Render(const Renderer& renderer) = 0;
+
+	unsigned int DrawsPerFrame = 0;
+	uint64_t BytesPerFrame = 0;
+};
+
+/*
+ * The path Application.cpp uses: one VBO/IBO and one Renderer::Draw per quad,
+ * each with its own VAO, or with VAOs shared through VertexArrayCache
+ */
+class ImmediateScene : public Scene
+{
+private:
+	Shader m_Shader;
+	Texture& m_Texture;
+	Grid m_Grid;
+	VertexBufferLayout m_Layout;
+	std::vector<std::unique_ptr<VertexArray>> m_VertexArrays;
+	std::vector<std::unique_ptr<VertexBuffer>> m_VertexBuffers;
+	std::vector<std::unique_ptr<IndexBuffer>> m_IndexBuffers;
+public:
+	ImmediateScene(unsigned int count, Texture& texture, bool cacheVertexArrays = false)
+		: m_Shader("res/shaders/Basic.shader"), m_Texture(texture), m_Grid(count)
+	{
+		m_Layout.Push<float>(2);
+		m_Layout.Push<float>(2);
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			m_VertexBuffers.push_back(std::make_unique<VertexBuffer>(s_QuadVertices, (unsigned int)sizeof(s_QuadVertices)));
+			m_IndexBuffers.push_back(std::make_unique<IndexBuffer>(s_QuadIndices));
+			if (!cacheVertexArrays)
+			{
+				m_VertexArrays.push_back(std::make_unique<VertexArray>());
+				m_VertexArrays.back()->Addbuffer(*m_VertexBuffers.back(), m_Layout);
+			}
+		}
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+
+		VertexArrayCache::Get().ResetStats();
+	}
+
+	~ImmediateScene()
+	{
+		if (!m_VertexArrays.empty())
+			return;
+
+		const VertexArrayCache& cache = VertexArrayCache::Get();
+		std::cout << "vaocache: " << (cache.UsesVertexAttribBinding() ? "shared formats" : "keyed by buffers") << ", "
+			<< cache.GetStats().GetHitRate() * 100.0f << "% hits, " << cache.GetLiveCount() << " live VAOs for "
+			<< m_VertexBuffers.size() << " meshes, " << cache.GetStats().VertexBufferBinds << " vertex buffer binds" << std::endl;
+	}
+
+	void Render(const Renderer& renderer) override
+	{
+		m_Texture.Bind();
+		DrawsPerFrame = 0;
+		BytesPerFrame = 0;
+
+		for (unsigned int i = 0; i < m_VertexBuffers.size(); i++)
+		{
+			glm::mat4 mvp = glm::translate(glm::mat4(1.0f), glm::vec3(m_Grid.Position(i), 0.0f));
+			mvp = glm::scale(mvp, glm::vec3(m_Grid.Cell * 0.9f));
+
+			m_Shader.Bind();
+			m_Shader.SetUniformMat4f("u_MVP", mvp);
+			if (m_VertexArrays.empty())
+				renderer.Draw(*m_VertexBuffers[i], m_Layout, *m_IndexBuffers[i], m_Shader);
+			else
+				renderer.Draw(*m_VertexArrays[i], *m_IndexBuffers[i], m_Shader);
+
+			DrawsPerFrame++;
+			BytesPerFrame += sizeof(glm::mat4);
+		}
+	}
+};
+
+/*
+ * count quads sharing four materials, drawn in material order. Every draw sets
+ * the material's sampler and its own transform the way a naive material
+ * system would; the uniform shadow drops the repeated sampler uploads.
+ */
+class MaterialScene : public Scene
+{
+private:
+	static const unsigned int MaterialCount = 4;
+
+	Shader m_Shader;
+	Texture& m_Texture;
+	Grid m_Grid;
+	unsigned int m_Count;
+	VertexArray m_VertexArray;
+	VertexBuffer m_VertexBuffer;
+	IndexBuffer m_IndexBuffer;
+	UniformHandle m_TextureUniform;
+	UniformHandle m_MVPUniform;
+public:
+	MaterialScene(unsigned int count, Texture& texture)
+		: m_Shader("res/shaders/Basic.shader"), m_Texture(texture), m_Grid(count), m_Count(count),
+		m_VertexBuffer(s_QuadVertices, (unsigned int)sizeof(s_QuadVertices)), m_IndexBuffer(s_QuadIndices)
+	{
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		m_VertexArray.Addbuffer(m_VertexBuffer, layout);
+
+		/* Resolved once, the draws below index the uniform table directly */
+		m_TextureUniform = m_Shader.GetUniformHandle("u_Texture");
+		m_MVPUniform = m_Shader.GetUniformHandle("u_MVP");
+	}
+
+	void Render(const Renderer& renderer) override
+	{
+		for (unsigned int slot = 0; slot < MaterialCount; slot++)
+			m_Texture.Bind(slot);
+
+		for (unsigned int i = 0; i < m_Count; i++)
+		{
+			glm::mat4 mvp = glm::translate(glm::mat4(1.0f), glm::vec3(m_Grid.Position(i), 0.0f));
+			mvp = glm::scale(mvp, glm::vec3(m_Grid.Cell * 0.9f));
+
+			m_Shader.SetUniform1i(m_TextureUniform, (int)(i * MaterialCount / m_Count));
+			m_Shader.SetUniformMat4f(m_MVPUniform, mvp);
+			renderer.Draw(m_VertexArray, m_IndexBuffer, m_Shader);
+		}
+
+		DrawsPerFrame = m_Count;
+		BytesPerFrame = (uint64_t)m_Count * sizeof(glm::mat4);
+	}
+};
+
+/* One shared mesh submitted count times through the sort-key RenderQueue */
+class QueueScene : public Scene
+{
+private:
+	Shader m_Shader;
+	Texture& m_Texture;
+	Grid m_Grid;
+	unsigned int m_Count;
+	VertexArray m_VertexArray;
+	VertexBuffer m_VertexBuffer;
+	IndexBuffer m_IndexBuffer;
+	RenderQueue m_Queue;
+public:
+	QueueScene(unsigned int count, Texture& texture)
+		: m_Shader("res/shaders/Basic.shader"), m_Texture(texture), m_Grid(count), m_Count(count),
+		m_VertexBuffer(s_QuadVertices, (unsigned int)sizeof(s_QuadVertices)), m_IndexBuffer(s_QuadIndices)
+	{
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		m_VertexArray.Addbuffer(m_VertexBuffer, layout);
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+	}
+
+	void Render(const Renderer& renderer) override
+	{
+		for (unsigned int i = 0; i < m_Count; i++)
+		{
+			glm::mat4 mvp = glm::translate(glm::mat4(1.0f), glm::vec3(m_Grid.Position(i), 0.0f));
+			mvp = glm::scale(mvp, glm::vec3(m_Grid.Cell * 0.9f));
+			m_Queue.Submit(m_VertexArray, m_IndexBuffer, m_Shader, &m_Texture, mvp, 0.5f, true);
+		}
+
+		m_Queue.ResetStats();
+		m_Queue.Flush(renderer);
+
+		DrawsPerFrame = m_Queue.GetStats().DrawCount;
+		BytesPerFrame = (uint64_t)DrawsPerFrame * sizeof(glm::mat4);
+	}
+};
+
+class BatchScene : public Scene
+{
+private:
+	Shader m_Shader;
+	Texture& m_Texture;
+	Grid m_Grid;
+	unsigned int m_Count;
+	BatchRenderer m_BatchRenderer;
+public:
+	BatchScene(unsigned int count, Texture& texture)
+		: m_Shader("res/shaders/Batch.shader"), m_Texture(texture), m_Grid(count), m_Count(count), m_BatchRenderer(m_Shader)
+	{
+	}
+
+	void Render(const Renderer& renderer) override
+	{
+		(void)renderer;
+		float size = m_Grid.Cell * 0.9f;
+
+		m_BatchRenderer.ResetStats();
+		m_BatchRenderer.Begin(glm::mat4(1.0f));
+		for (unsigned int i = 0; i < m_Count; i++)
+			m_BatchRenderer.DrawQuad(m_Grid.Position(i) - size * 0.5f, { size, size }, m_Texture);
+		m_BatchRenderer.End();
+
+		DrawsPerFrame = m_BatchRenderer.GetStats().DrawCount;
+		BytesPerFrame = (uint64_t)m_BatchRenderer.GetStats().QuadCount * 4 * sizeof(QuadVertex);
+	}
+};
+
+class InstancedScene : public Scene
+{
+private:
+	Shader m_Shader;
+	Texture& m_Texture;
+	unsigned int m_Count;
+	VertexArray m_VertexArray;
+	VertexBuffer m_VertexBuffer;
+	std::unique_ptr<VertexBuffer> m_InstanceBuffer;
+	IndexBuffer m_IndexBuffer;
+public:
+	InstancedScene(unsigned int count, Texture& texture)
+		: m_Shader("res/shaders/Instanced.shader"), m_Texture(texture), m_Count(count),
+		m_VertexBuffer(s_QuadVertices, (unsigned int)sizeof(s_QuadVertices)), m_IndexBuffer(s_QuadIndices)
+	{
+		Grid grid(count);
+		std::vector<glm::vec2> offsets(count);
+		for (unsigned int i = 0; i < count; i++)
+			offsets[i] = grid.Position(i);
+		m_InstanceBuffer = std::make_unique<VertexBuffer>(offsets.data(), (unsigned int)(offsets.size() * sizeof(glm::vec2)));
+
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		m_VertexArray.Addbuffer(m_VertexBuffer, layout);
+
+		VertexBufferLayout instanceLayout;
+		instanceLayout.Push<float>(2, 1);
+		m_VertexArray.Addbuffer(*m_InstanceBuffer, instanceLayout);
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+		m_Shader.SetUniformMat4f("u_MVP", glm::mat4(1.0f));
+		m_Shader.SetUniform1f("u_Scale", grid.Cell * 0.9f);
+	}
+
+	void Render(const Renderer& renderer) override
+	{
+		m_Texture.Bind();
+		renderer.DrawInstanced(m_VertexArray, m_IndexBuffer, m_Shader, m_Count);
+
+		DrawsPerFrame = 1;
+		BytesPerFrame = 0;
+	}
+};
+
+/* One mesh of count quads in a Dynamic buffer, clusters of 8 quads (about 3% of them) move every frame */
+class AnimatedScene : public Scene
+{
+private:
+	static const unsigned int ClusterSize = 8;
+	static const unsigned int ClusterPeriod = 32;
+
+	Shader m_Shader;
+	Texture& m_Texture;
+	Grid m_Grid;
+	unsigned int m_Count;
+	unsigned int m_Frame;
+	VertexArray m_VertexArray;
+	std::unique_ptr<VertexBuffer> m_VertexBuffer;
+	std::unique_ptr<IndexBuffer> m_IndexBuffer;
+
+	void GetQuad(unsigned int i, float scale, float* vertices) const
+	{
+		glm::vec2 center = m_Grid.Position(i);
+		for (unsigned int v = 0; v < 4; v++)
+		{
+			vertices[v * 4 + 0] = center.x + s_QuadVertices[v * 4 + 0] * m_Grid.Cell * scale;
+			vertices[v * 4 + 1] = center.y + s_QuadVertices[v * 4 + 1] * m_Grid.Cell * scale;
+			vertices[v * 4 + 2] = s_QuadVertices[v * 4 + 2];
+			vertices[v * 4 + 3] = s_QuadVertices[v * 4 + 3];
+		}
+	}
+public:
+	AnimatedScene(unsigned int count, Texture& texture)
+		: m_Shader("res/shaders/Basic.shader"), m_Texture(texture), m_Grid(count), m_Count(count), m_Frame(0)
+	{
+		std::vector<float> vertices(count * 16);
+		std::vector<unsigned int> indices(count * 6);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			GetQuad(i, 0.9f, &vertices[i * 16]);
+			for (unsigned int j = 0; j < 6; j++)
+				indices[i * 6 + j] = i * 4 + s_QuadIndices[j];
+		}
+
+		m_VertexBuffer = std::make_unique<VertexBuffer>(vertices.data(), (unsigned int)(vertices.size() * sizeof(float)), BufferUsage::Dynamic);
+		m_IndexBuffer = std::make_unique<IndexBuffer>(indices);
+
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		m_VertexArray.Addbuffer(*m_VertexBuffer, layout);
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+		m_Shader.SetUniformMat4f("u_MVP", glm::mat4(1.0f));
+	}
+
+	void Render(const Renderer& renderer) override
+	{
+		float scale = 0.6f + 0.3f * (float)((m_Frame++ % 16) / 15.0);
+
+		BufferShadow::ResetStats();
+
+		/* One Update per quad, the Renderer merges each cluster into a single upload */
+		float quad[16];
+		for (unsigned int i = 0; i < m_Count; i++)
+		{
+			if ((i / ClusterSize) % ClusterPeriod != 0)
+				continue;
+
+			GetQuad(i, scale, quad);
+			m_VertexBuffer->Update(i * (unsigned int)sizeof(quad), quad, (unsigned int)sizeof(quad));
+		}
+
+		m_Texture.Bind();
+		renderer.Draw(m_VertexArray, *m_IndexBuffer, m_Shader);
+
+		DrawsPerFrame = 1;
+		BytesPerFrame = BufferShadow::GetStats().BytesUploaded;
+	}
+};
+
+/* Every quad is its own mesh in a GeometryPool: one VAO bind per page instead of per quad */
+class PoolScene : public Scene
+{
+private:
+	Shader m_Shader;
+	Texture& m_Texture;
+	GeometryPool m_Pool;
+	std::vector<unsigned int> m_Meshes;
+
+	static VertexBufferLayout GetLayout()
+	{
+		VertexBufferLayout layout;
+		layout.Push<float>(2);
+		layout.Push<float>(2);
+		return layout;
+	}
+
+	static void PrintStats(const char* when, const GeometryPool::Stats& stats)
+	{
+		std::cout << "pool " << when << ": " << stats.Meshes << " meshes in " << stats.Pages << " pages, occupancy "
+			<< stats.GetVertexOccupancy() * 100.0f << "% / " << stats.GetIndexOccupancy() * 100.0f << "%, fragmentation "
+			<< stats.VertexFragmentation * 100.0f << "% / " << stats.IndexFragmentation * 100.0f << "% (vertices / indices)" << std::endl;
+	}
+public:
+	PoolScene(unsigned int count, Texture& texture)
+		: m_Shader("res/shaders/Basic.shader"), m_Texture(texture), m_Pool(GetLayout(), 1 << 14, 6 << 12)
+	{
+		/* Interleave throw-away meshes with the real ones and remove them to leave holes behind */
+		Grid grid(count);
+		std::vector<unsigned int> garbage;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			glm::vec2 center = grid.Position(i);
+			float vertices[16];
+			for (unsigned int v = 0; v < 4; v++)
+			{
+				vertices[v * 4 + 0] = center.x + s_QuadVertices[v * 4 + 0] * grid.Cell * 0.9f;
+				vertices[v * 4 + 1] = center.y + s_QuadVertices[v * 4 + 1] * grid.Cell * 0.9f;
+				vertices[v * 4 + 2] = s_QuadVertices[v * 4 + 2];
+				vertices[v * 4 + 3] = s_QuadVertices[v * 4 + 3];
+			}
+
+			m_Meshes.push_back(m_Pool.Add(vertices, 4, s_QuadIndices, 6));
+			garbage.push_back(m_Pool.Add(vertices, 4, s_QuadIndices, 6));
+		}
+
+		for (unsigned int mesh : garbage)
+			m_Pool.Remove(mesh);
+
+		PrintStats("before defragment", m_Pool.GetStats());
+		m_Pool.Defragment();
+		PrintStats("after defragment", m_Pool.GetStats());
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+		m_Shader.SetUniformMat4f("u_MVP", glm::mat4(1.0f));
+	}
+
+	void Render(const Renderer& renderer) override
+	{
+		m_Texture.Bind();
+		for (unsigned int mesh : m_Meshes)
+			renderer.Draw(m_Pool, mesh, m_Shader);
+
+		DrawsPerFrame = (unsigned int)m_Meshes.size();
+		BytesPerFrame = 0;
+	}
+};
+
+/* Rows of spheres receding from a camera that dollies back and forth, each drawn at the LOD its screen-space error allows */
+class LodScene : public Scene
+{
+private:
+	static const unsigned int Segments = 64;
+
+	Shader m_Shader;
+	Texture& m_Texture;
+	unsigned int m_Count;
+	unsigned int m_Frame;
+	VertexArray m_VertexArray;
+	std::unique_ptr<VertexBuffer> m_VertexBuffer;
+	std::unique_ptr<IndexBuffer> m_IndexBuffer;
+	LodChain m_Lods;
+	std::vector<unsigned int> m_Levels;
+
+	uint64_t m_Triangles;
+	uint64_t m_Switches;
+public:
+	LodScene(unsigned int count, Texture& texture)
+		: m_Shader("res/shaders/Basic.shader"), m_Texture(texture), m_Count(count), m_Frame(0), m_Levels(count, 0),
+		m_Triangles(0), m_Switches(0)
+	{
+		std::vector<SphereVertex> vertices;
+		std::vector<unsigned int> indices;
+		BuildSphere(Segments, vertices, indices);
+
+		m_Lods = LodChain::Build(indices, vertices[0].Position, (unsigned int)vertices.size(), (unsigned int)sizeof(SphereVertex),
+			6, 0.5f, vertices[0].TexCoord, 2);
+		for (unsigned int level = 0; level < m_Lods.GetLevelCount(); level++)
+		{
+			std::cout << "lod " << level << ": " << m_Lods.GetLevel(level).IndexCount / 3 << " triangles, error "
+				<< m_Lods.GetLevel(level).Error << std::endl;
+		}
+
+		m_VertexBuffer = std::make_unique<VertexBuffer>(vertices.data(), (unsigned int)(vertices.size() * sizeof(SphereVertex)));
+		m_IndexBuffer = std::make_unique<IndexBuffer>(indices);
+		m_VertexArray.Addbuffer(*m_VertexBuffer, SphereVertexLayout);
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+	}
+
+	~LodScene()
+	{
+		if (m_Frame == 0)
+			return;
+
+		std::cout << "lod: " << m_Triangles / m_Frame << " triangles per frame instead of "
+			<< (uint64_t)m_Count * (m_Lods.GetLevel(0).IndexCount / 3) << ", " << m_Switches << " level switches" << std::endl;
+	}
+
+	void Render(const Renderer& renderer) override
+	{
+		const float FovY = glm::radians(45.0f);
+		GLint viewport[4];
+		GLCall(glGetIntegerv(GL_VIEWPORT, viewport));
+
+		glm::mat4 projection = glm::perspective(FovY, (float)viewport[2] / viewport[3], 0.1f, 1000.0f);
+		glm::vec3 camera(0.0f, 0.0f, 20.0f * std::sin(m_Frame++ * 0.05f));
+		glm::mat4 viewProjection = projection * glm::translate(glm::mat4(1.0f), -camera);
+
+		unsigned int side = 1;
+		while (side * side < m_Count)
+			side++;
+
+		m_Texture.Bind();
+		for (unsigned int i = 0; i < m_Count; i++)
+		{
+			glm::vec3 position((i % side - side * 0.5f) * 3.0f, 0.0f, -5.0f - (i / side) * 3.0f);
+
+			float pixelsPerUnit = LodChain::GetPixelsPerUnit(glm::length(position - camera), FovY, (float)viewport[3]);
+			unsigned int level = m_Lods.Select(pixelsPerUnit, m_Levels[i]);
+			m_Switches += level != m_Levels[i];
+			m_Levels[i] = level;
+			m_Triangles += m_Lods.GetLevel(level).IndexCount / 3;
+
+			m_Shader.SetUniformMat4f("u_MVP", viewProjection * glm::translate(glm::mat4(1.0f), position));
+			renderer.Draw(m_VertexArray, *m_IndexBuffer, m_Shader, m_Lods, level);
+		}
+
+		DrawsPerFrame = m_Count;
+		BytesPerFrame = 0;
+	}
+};
+
+/* A grid of lit spheres, either as float vertices or packed by VertexQuantizer to compare vertex bandwidth */
+class MeshScene : public Scene
+{
+private:
+	static const unsigned int Segments = 64;
+
+	Shader m_Shader;
+	Texture& m_Texture;
+	Grid m_Grid;
+	VertexArray m_VertexArray;
+	std::unique_ptr<VertexBuffer> m_VertexBuffer;
+	std::unique_ptr<IndexBuffer> m_IndexBuffer;
+	unsigned int m_Count;
+	glm::mat4 m_PositionDecode;
+public:
+	MeshScene(unsigned int count, Texture& texture, bool quantize)
+		: m_Shader("res/shaders/Mesh.shader"), m_Texture(texture), m_Grid(count), m_Count(count), m_PositionDecode(1.0f)
+	{
+		std::vector<SphereVertex> vertices;
+		std::vector<unsigned int> indices;
+		BuildSphere(Segments, vertices, indices);
+		m_IndexBuffer = std::make_unique<IndexBuffer>(indices);
+
+		if (quantize)
+		{
+			VertexQuantizer::Attributes attributes;
+			attributes.Position = (int)offsetof(SphereVertex, Position);
+			attributes.TexCoord = (int)offsetof(SphereVertex, TexCoord);
+			attributes.Normal = (int)offsetof(SphereVertex, Normal);
+
+			VertexQuantizer::Mesh mesh = VertexQuantizer::Quantize(vertices.data(), (unsigned int)vertices.size(), (unsigned int)sizeof(SphereVertex), attributes);
+			std::cout << "mesh: " << mesh.Stats.SourceBytes << " -> " << mesh.Stats.PackedBytes << " vertex bytes ("
+				<< mesh.Stats.GetSavedFraction() * 100.0f << "% saved), max normal error " << mesh.Stats.MaxNormalError << " degrees" << std::endl;
+
+			m_VertexBuffer = std::make_unique<VertexBuffer>(mesh.Vertices.data(), (unsigned int)mesh.Vertices.size());
+			m_VertexArray.Addbuffer(*m_VertexBuffer, mesh.Layout);
+			m_PositionDecode = mesh.PositionDecode;
+		}
+		else
+		{
+			m_VertexBuffer = std::make_unique<VertexBuffer>(vertices.data(), (unsigned int)(vertices.size() * sizeof(SphereVertex)));
+			m_VertexArray.Addbuffer(*m_VertexBuffer, SphereVertexLayout);
+			std::cout << "mesh: " << vertices.size() * sizeof(SphereVertex) << " vertex bytes" << std::endl;
+		}
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i("u_Texture", 0);
+		m_Shader.SetUniform1i("u_OctahedralNormals", quantize ? 1 : 0);
+	}
+
+	void Render(const Renderer& renderer) override
+	{
+		m_Texture.Bind();
+		for (unsigned int i = 0; i < m_Count; i++)
+		{
+			glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(m_Grid.Position(i), 0.0f));
+			model = glm::scale(model, glm::vec3(m_Grid.Cell * 0.45f)) * m_PositionDecode;
+			m_Shader.SetUniformMat4f("u_MVP", model);
+			renderer.Draw(m_VertexArray, *m_IndexBuffer, m_Shader);
+		}
+
+		DrawsPerFrame = m_Count;
+		BytesPerFrame = 0;
+	}
+};
+
+static std::unique_ptr<Scene> CreateScene(const std::string& name, unsigned int count, Texture& texture)
+{
+	if (name == "immediate")	return std::make_unique<ImmediateScene>(count, texture);
+	if (name == "vaocache")		return std::make_unique<ImmediateScene>(count, texture, true);
+	if (name == "queue")		return std::make_unique<QueueScene>(count, texture);
+	if (name == "materials")	return std::make_unique<MaterialScene>(count, texture);
+	if (name == "batch")		return std::make_unique<BatchScene>(count, texture);
+	if (name == "instanced")	return std::make_unique<InstancedScene>(count, texture);
+	if (name == "animated")		return std::make_unique<AnimatedScene>(count, texture);
+	if (name == "pool")			return std::make_unique<PoolScene>(count, texture);
+	if (name == "lod")			return std::make_unique<LodScene>(count, texture);
+	if (name == "mesh")			return std::make_unique<MeshScene>(count, texture, false);
+	if (name == "quantized")	return std::make_unique<MeshScene>(count, texture, true);
+	return nullptr;
+}
+
+static double Percentile(const std::vector<double>& sorted, double p)
+{
+	size_t index = (size_t)(p * (sorted.size() - 1) + 0.5);
+	return sorted[std::min(index, sorted.size() - 1)];
+}
+
+int main(int argc, char** argv)
+{
+	std::string sceneName = "all";
+	std::string output;
+	unsigned int count = 10000;
+	unsigned int frames = 300;
+	unsigned int warmup = 10;
+	int width = 640, height = 480;
+	bool directStateAccess = true;
+
+	for (int i = 1; i < argc; i += 2)
+	{
+		std::string option = argv[i];
+		if (i + 1 == argc)
+		{
+			std::cout << "Missing value for " << option << std::endl;
+			return 1;
+		}
+		std::string value = argv[i + 1];
+
+		if (option == "--scene")			sceneName = value;
+		else if (option == "--count")	count = (unsigned int)std::stoul(value);
+		else if (option == "--frames")	frames = (unsigned int)std::stoul(value);
+		else if (option == "--warmup")	warmup = (unsigned int)std::stoul(value);
+		else if (option == "--width")	width = std::stoi(value);
+		else if (option == "--height")	height = std::stoi(value);
+		else if (option == "--dsa")		directStateAccess = value != "0";
+		else if (option == "--output")	output = value;
+		else
+		{
+			std::cout << "Unknown option " << option << std::endl;
+			return 1;
+		}
+	}
+
+	/* Percentiles and per-frame averages need at least one measured frame */
+	if (frames == 0)
+	{
+		std::cout << "--frames must be at least 1" << std::endl;
+		return 1;
+	}
+
+	HeadlessContext context(width, height);
+	if (!context.Init())
+		return -1;
+
+	GLState::Get().SetDirectStateAccess(directStateAccess);
+
+	std::vector<std::string> sceneNames;
+	if (sceneName == "all")
+		sceneNames = { "immediate", "vaocache", "queue", "materials", "batch", "instanced", "animated", "pool", "lod", "mesh", "quantized" };
+	else
+		sceneNames = { sceneName };
+
+	double zoneOverheadNs = Profiler::Get().MeasureOverhead();
+	std::cout << "profiler: " << zoneOverheadNs << " ns per zone" << std::endl;
+
+	std::stringstream json;
+	json << "{\n  \"backend\": \"" << context.GetBackend() << "\",\n"
+		<< "  \"renderer\": \"" << glGetString(GL_RENDERER) << "\",\n"
+		<< "  \"version\": \"" << glGetString(GL_VERSION) << "\",\n"
+		<< "  \"direct_state_access\": " << (GLState::Get().UseDirectStateAccess() ? "true" : "false") << ",\n"
+		<< "  \"width\": " << width << ", \"height\": " << height << ",\n"
+		<< "  \"profile_zone_overhead_ns\": " << zoneOverheadNs << ",\n"
+		<< "  \"scenes\": [";
+
+	{
+		GLCall(glEnable(GL_BLEND));
+		GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+
+		Texture texture("res/textures/Ryzen.png");
+		Renderer renderer;
+
+		for (size_t s = 0; s < sceneNames.size(); s++)
+		{
+			unsigned long long setupCalls = GLCallCount();
+			std::unique_ptr<Scene> scene = CreateScene(sceneNames[s], count, texture);
+			setupCalls = GLCallCount() - setupCalls;
+			if (!scene)
+			{
+				std::cout << "Unknown scene " << sceneNames[s] << std::endl;
+				return 1;
+			}
+
+			std::vector<double> frameTimes;
+			uint64_t bytesTotal = 0;
+			unsigned int drawsTotal = 0;
+			unsigned long long callsTotal = 0;
+			unsigned long long uniformsIssued = 0;
+			unsigned long long uniformsSkipped = 0;
+
+			for (unsigned int frame = 0; frame < warmup + frames; frame++)
+			{
+				double start = NowMs();
+				unsigned long long calls = GLCallCount();
+				UniformTable::ResetStats();
+				GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+				scene->Render(renderer);
+				calls = GLCallCount() - calls;
+				UniformTable::Stats uniformStats = UniformTable::GetStats();
+				/* Wait for the GPU so the frame time covers the whole frame, not just submission */
+				GLCall(glFinish());
+				double end = NowMs();
+
+				if (frame < warmup)
+					continue;
+
+				frameTimes.push_back(end - start);
+				bytesTotal += scene->BytesPerFrame;
+				drawsTotal += scene->DrawsPerFrame;
+				callsTotal += calls;
+				uniformsIssued += uniformStats.Issued;
+				uniformsSkipped += uniformStats.Skipped;
+			}
+
+			std::vector<double> sorted = frameTimes;
+			std::sort(sorted.begin(), sorted.end());
+			double total = 0.0;
+			for (double ms : sorted)
+				total += ms;
+
+			json << (s ? "," : "") << "\n    {\n"
+				<< "      \"name\": \"" << sceneNames[s] << "\", \"count\": " << count << ", \"frames\": " << frames << ",\n"
+				<< "      \"frame_ms\": { \"mean\": " << total / sorted.size()
+				<< ", \"min\": " << sorted.front() << ", \"p50\": " << Percentile(sorted, 0.5)
+				<< ", \"p90\": " << Percentile(sorted, 0.9) << ", \"p99\": " << Percentile(sorted, 0.99)
+				<< ", \"max\": " << sorted.back() << " },\n"
+				<< "      \"draws_per_frame\": " << (double)drawsTotal / frames << ",\n"
+				<< "      \"bytes_uploaded_per_frame\": " << (double)bytesTotal / frames << ",\n"
+				<< "      \"bytes_uploaded_total\": " << bytesTotal << ",\n"
+				<< "      \"gl_calls_setup\": " << setupCalls << ", \"gl_calls_per_frame\": " << (double)callsTotal / frames << ",\n"
+				<< "      \"uniform_uploads_per_frame\": " << (double)uniformsIssued / frames
+				<< ", \"uniform_uploads_skipped_per_frame\": " << (double)uniformsSkipped / frames << "\n    }";
+
+			std::cout << sceneNames[s] << ": " << Percentile(sorted, 0.5) << " ms p50, "
+				<< (double)drawsTotal / frames << " draws/frame, " << setupCalls << " GL calls to create, "
+				<< (double)callsTotal / frames << " GL calls/frame, " << (double)uniformsIssued / frames << " uniform uploads/frame ("
+				<< (double)uniformsSkipped / frames << " skipped)" << std::endl;
+		}
+	}
+
+	/* The cache outlives context, delete its VAOs while the context is still current */
+	VertexArrayCache::Get().Clear();
+
+	json << "\n  ]\n}\n";
+
+	if (output.empty())
+	{
+		std::cout << json.str();
+	}
+	else
+	{
+		std::ofstream stream(output);
+		stream << json.str();
+	}
+
+	return 0;
+}
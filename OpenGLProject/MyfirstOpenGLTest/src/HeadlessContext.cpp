@@ -0,0 +1,183 @@
+#include "HeadlessContext.h"
+
+#include <iostream>
+
+#include "Renderer.h"
+
+#ifdef HEADLESS_OSMESA
+#include <GL/osmesa.h>
+#else
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+HeadlessContext::HeadlessContext(int width, int height)
+	: m_Width(width), m_Height(height), m_Display(nullptr), m_Context(nullptr),
+	m_Framebuffer(0), m_ColorBuffer(0), m_DepthBuffer(0)
+{
+}
+
+HeadlessContext::~HeadlessContext()
+{
+	if (m_Framebuffer)
+	{
+		GLCall(glDeleteRenderbuffers(1, &m_ColorBuffer));
+		GLCall(glDeleteRenderbuffers(1, &m_DepthBuffer));
+		GLCall(glDeleteFramebuffers(1, &m_Framebuffer));
+	}
+
+	DestroyContext();
+}
+
+bool HeadlessContext::Init()
+{
+	if (!CreateContext())
+		return false;
+
+	/* Core profile entry points are only loaded with glewExperimental */
+	glewExperimental = GL_TRUE;
+	GLenum result = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+	/* A GLX build of GLEW loads the GL entry points and then fails to find an X display, which is expected here */
+	if (result == GLEW_ERROR_NO_GLX_DISPLAY)
+		result = GLEW_OK;
+#endif
+	if (result != GLEW_OK)
+	{
+		std::cout << "Error: glewInit failed (" << glewGetErrorString(result) << ")" << std::endl;
+		return false;
+	}
+
+	GLCall(glGenFramebuffers(1, &m_Framebuffer));
+	GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer));
+
+	GLCall(glGenRenderbuffers(1, &m_ColorBuffer));
+	GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_ColorBuffer));
+	GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_Width, m_Height));
+	GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorBuffer));
+
+	GLCall(glGenRenderbuffers(1, &m_DepthBuffer));
+	GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_DepthBuffer));
+	GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_Width, m_Height));
+	GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthBuffer));
+
+	GLenum status;
+	GLCall(status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "Error: framebuffer incomplete (" << status << ")" << std::endl;
+		return false;
+	}
+
+	GLCall(glViewport(0, 0, m_Width, m_Height));
+	return true;
+}
+
+#ifdef HEADLESS_OSMESA
+
+bool HeadlessContext::CreateContext()
+{
+	m_Backend = "OSMesa";
+
+	const int attributes[] = {
+		OSMESA_FORMAT, OSMESA_RGBA,
+		OSMESA_DEPTH_BITS, 24,
+		OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+		OSMESA_CONTEXT_MAJOR_VERSION, 4,
+		OSMESA_CONTEXT_MINOR_VERSION, 5,
+		0
+	};
+
+	OSMesaContext context = OSMesaCreateContextAttribs(attributes, nullptr);
+	if (!context)
+	{
+		std::cout << "Error: OSMesaCreateContextAttribs failed" << std::endl;
+		return false;
+	}
+	m_Context = context;
+
+	m_OSMesaBuffer.resize((size_t)m_Width * m_Height * 4);
+	if (!OSMesaMakeCurrent(context, m_OSMesaBuffer.data(), GL_UNSIGNED_BYTE, m_Width, m_Height))
+	{
+		std::cout << "Error: OSMesaMakeCurrent failed" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+void HeadlessContext::DestroyContext()
+{
+	if (m_Context)
+		OSMesaDestroyContext((OSMesaContext)m_Context);
+	m_Context = nullptr;
+}
+
+#else
+
+bool HeadlessContext::CreateContext()
+{
+	m_Backend = "EGL surfaceless";
+
+	auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	EGLDisplay display = getPlatformDisplay
+		? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+		: eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+	{
+		std::cout << "Error: no EGL display" << std::endl;
+		return false;
+	}
+	m_Display = display;
+
+	if (!eglBindAPI(EGL_OPENGL_API))
+	{
+		std::cout << "Error: EGL has no desktop OpenGL" << std::endl;
+		return false;
+	}
+
+	/* Prefer 4.5 core for the indirect and instanced paths, fall back to what the wrappers need */
+	const int versions[][2] = { { 4, 5 }, { 4, 3 }, { 3, 3 } };
+	for (const auto& version : versions)
+	{
+		const EGLint attributes[] = {
+			EGL_CONTEXT_MAJOR_VERSION, version[0],
+			EGL_CONTEXT_MINOR_VERSION, version[1],
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_NONE
+		};
+
+		/* Surfaceless contexts need neither a config (KHR_no_config_context) nor a surface */
+		EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+		if (context != EGL_NO_CONTEXT)
+		{
+			m_Context = context;
+			break;
+		}
+	}
+
+	if (!m_Context || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, (EGLContext)m_Context))
+	{
+		std::cout << "Error: could not create a surfaceless GL context" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+void HeadlessContext::DestroyContext()
+{
+	if (!m_Display)
+		return;
+
+	eglMakeCurrent((EGLDisplay)m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	if (m_Context)
+		eglDestroyContext((EGLDisplay)m_Display, (EGLContext)m_Context);
+	eglTerminate((EGLDisplay)m_Display);
+
+	m_Context = nullptr;
+	m_Display = nullptr;
+}
+
+#endif
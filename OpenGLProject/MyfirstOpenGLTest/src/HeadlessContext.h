@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/*
+ * A GL context without a window or a display server, for benchmarks on CI
+ * and GPU-less machines (Mesa llvmpipe works). The default backend is EGL on
+ * the Mesa surfaceless platform; build with HEADLESS_OSMESA to use OSMesa.
+ *
+ * There is no default framebuffer, so the context renders into an FBO of the
+ * requested size which stays bound for the lifetime of the context.
+ */
+class HeadlessContext
+{
+private:
+	int m_Width, m_Height;
+	std::string m_Backend;
+
+	void* m_Display;
+	void* m_Context;
+	std::vector<unsigned char> m_OSMesaBuffer;
+
+	unsigned int m_Framebuffer;
+	unsigned int m_ColorBuffer;
+	unsigned int m_DepthBuffer;
+public:
+	HeadlessContext(int width, int height);
+	~HeadlessContext();
+
+	/* Creates the context, makes it current, initializes GLEW and binds the FBO */
+	bool Init();
+
+	inline int GetWidth() const { return m_Width; }
+	inline int GetHeight() const { return m_Height; }
+	inline const std::string& GetBackend() const { return m_Backend; }
+private:
+	bool CreateContext();
+	void DestroyContext();
+};
\ No newline at end of file
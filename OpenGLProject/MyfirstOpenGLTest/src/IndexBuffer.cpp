@@ -1,27 +1,122 @@
 #include "IndexBuffer.h"
 #include "Renderer.h"
+#include "VertexArrayCache.h"
 
-IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
-	:m_Count(count)
+#include <algorithm>
+
+/* Copies count indices into the narrower type T */
+template<typename T>
+static std::vector<T> Narrow(const unsigned int* indices, unsigned int count)
+{
+	std::vector<T> narrowed(count);
+	for (unsigned int i = 0; i < count; i++)
+		narrowed[i] = (T)indices[i];
+	return narrowed;
+}
+
+IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count, BufferUsage usage)
+	:m_Count(count), m_Usage(usage)
+{
+	if (count == 0)
+	{
+		m_Type = GL_UNSIGNED_BYTE;
+		Create(nullptr, usage);
+		return;
+	}
+
+	m_Type = GetTypeFor(*std::max_element(data, data + count));
+
+	switch (m_Type)
+	{
+	case GL_UNSIGNED_BYTE:	Create(Narrow<unsigned char>(data, count).data(), usage); break;
+	case GL_UNSIGNED_SHORT:	Create(Narrow<unsigned short>(data, count).data(), usage); break;
+	default:				Create(data, usage); break;
+	}
+}
+
+IndexBuffer::IndexBuffer(unsigned int count, unsigned int type, BufferUsage usage /*= BufferUsage::Dynamic*/)
+	:m_Count(count), m_Type(type), m_Usage(usage)
+{
+	Create(nullptr, usage);
+}
+
+void IndexBuffer::Create(const void* data, BufferUsage usage)
 {
-	ASSERT(sizeof(unsigned int) == sizeof(GLuint));
+	unsigned int size = m_Count * GetIndexSize();
 
-	GLCall(glGenBuffers(1, &m_RendererID));
-	GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
-	GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(GLuint), data, GL_STATIC_DRAW));
+	m_RendererID = CreateBuffer(GL_ELEMENT_ARRAY_BUFFER, data, size, usage);
+
+	if (usage != BufferUsage::Static)
+		m_Shadow = std::make_unique<BufferShadow>(m_RendererID, data, size);
 }
 
 IndexBuffer::~IndexBuffer()
 {
+	GLState::Get().OnDeleteBuffer(m_RendererID);
+	VertexArrayCache::Get().OnDeleteBuffer(m_RendererID);
 	GLCall(glDeleteBuffers(1, &m_RendererID));
 }
 
+void IndexBuffer::Update(unsigned int offset, const void* data, unsigned int size)
+{
+	ASSERT(offset + size <= m_Count * GetIndexSize());
+
+	if (m_Shadow)
+	{
+		m_Shadow->Write(offset, data, size);
+		return;
+	}
+
+	UploadBuffer(m_RendererID, offset, data, size, m_Usage);
+}
+
+void IndexBuffer::UpdateIndices(unsigned int first, const unsigned int* indices, unsigned int count)
+{
+	if (count == 0)
+		return;
+
+	/* An index that does not fit the type would silently wrap around */
+	ASSERT(GetSizeOfType(GetTypeFor(*std::max_element(indices, indices + count))) <= GetIndexSize());
+
+	unsigned int offset = first * GetIndexSize();
+	unsigned int size = count * GetIndexSize();
+
+	switch (m_Type)
+	{
+	case GL_UNSIGNED_BYTE:	Update(offset, Narrow<unsigned char>(indices, count).data(), size); break;
+	case GL_UNSIGNED_SHORT:	Update(offset, Narrow<unsigned short>(indices, count).data(), size); break;
+	default:				Update(offset, indices, size); break;
+	}
+}
+
 void IndexBuffer::Bind() const
 {
-	GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+	GLState::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
 }
 
 void IndexBuffer::UnBind() const
 {
-	GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+	GLState::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+unsigned int IndexBuffer::GetTypeFor(unsigned int maxIndex)
+{
+	if (maxIndex <= 0xff)
+		return GL_UNSIGNED_BYTE;
+	if (maxIndex <= 0xffff)
+		return GL_UNSIGNED_SHORT;
+	return GL_UNSIGNED_INT;
+}
+
+unsigned int IndexBuffer::GetSizeOfType(unsigned int type)
+{
+	switch (type)
+	{
+	case GL_UNSIGNED_BYTE:	return 1;
+	case GL_UNSIGNED_SHORT:	return 2;
+	case GL_UNSIGNED_INT:	return 4;
+	}
+
+	ASSERT(false);
+	return 0;
 }
@@ -1,16 +1,56 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "BufferShadow.h"
+
 class IndexBuffer 
 {
 private:
 	unsigned int m_RendererID;
 	unsigned int m_Count;
+	/* GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT */
+	unsigned int m_Type;
+	BufferUsage m_Usage;
+	/* Dynamic and Stream buffers keep a CPU copy so Update() calls can be merged */
+	std::unique_ptr<BufferShadow> m_Shadow;
+
+	void Create(const void* data, BufferUsage usage);
+
+	/* Only reached through the overloads below, a bare pointer says nothing about how many indices it holds */
+	IndexBuffer(const unsigned int* data, unsigned int count, BufferUsage usage);
 public:
-	IndexBuffer(const unsigned int* data, unsigned int count);
+	/*
+	 * Stored as the smallest type that holds the largest index, see GetTypeFor.
+	 * These take the count from the data itself, so the two cannot disagree;
+	 * an empty vector gives an empty buffer.
+	 */
+	template<size_t N>
+	IndexBuffer(const unsigned int (&data)[N], BufferUsage usage = BufferUsage::Static)
+		: IndexBuffer(data, (unsigned int)N, usage) {}
+	IndexBuffer(const std::vector<unsigned int>& data, BufferUsage usage = BufferUsage::Static)
+		: IndexBuffer(data.data(), (unsigned int)data.size(), usage) {}
+	/* Uninitialised store of count indices of the given type, to be filled with Update/UpdateIndices */
+	IndexBuffer(unsigned int count, unsigned int type, BufferUsage usage = BufferUsage::Dynamic);
 	~IndexBuffer();
 
+	/* Writes size bytes at offset, already in the buffer's index type; uploaded like VertexBuffer::Update */
+	void Update(unsigned int offset, const void* data, unsigned int size);
+	/* Converts count indices to the buffer's type and writes them from index first on */
+	void UpdateIndices(unsigned int first, const unsigned int* indices, unsigned int count);
+
 	void Bind() const;
 	void UnBind() const;
 
+	inline unsigned int GetRendererID() const { return m_RendererID; }
 	inline unsigned int GetCount() const { return m_Count; }
+	inline unsigned int GetType() const { return m_Type; }
+	inline unsigned int GetIndexSize() const { return GetSizeOfType(m_Type); }
+	inline BufferUsage GetUsage() const { return m_Usage; }
+
+	/* GL_UNSIGNED_BYTE up to 255, GL_UNSIGNED_SHORT up to 65535, GL_UNSIGNED_INT above */
+	static unsigned int GetTypeFor(unsigned int maxIndex);
+	static unsigned int GetSizeOfType(unsigned int type);
 };
\ No newline at end of file
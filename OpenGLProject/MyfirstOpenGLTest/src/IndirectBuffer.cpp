@@ -0,0 +1,68 @@
+#include "IndirectBuffer.h"
+
+#include <algorithm>
+
+#include "Renderer.h"
+
+IndirectBuffer::IndirectBuffer(unsigned int capacity /*= 256*/)
+	: m_Capacity(capacity), m_InstanceCount(0), m_Dirty(false)
+{
+	m_Commands.reserve(capacity);
+
+	GLCall(glGenBuffers(1, &m_RendererID));
+	Bind();
+	GLCall(glBufferData(GL_DRAW_INDIRECT_BUFFER, m_Capacity * sizeof(DrawElementsIndirectCommand), nullptr, GL_DYNAMIC_DRAW));
+}
+
+IndirectBuffer::~IndirectBuffer()
+{
+	GLState::Get().OnDeleteBuffer(m_RendererID);
+	GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+unsigned int IndirectBuffer::AddDraw(unsigned int count, unsigned int firstIndex, int baseVertex, unsigned int instanceCount /*= 1*/)
+{
+	unsigned int baseInstance = m_InstanceCount;
+	m_Commands.push_back({ count, instanceCount, firstIndex, baseVertex, baseInstance });
+	m_InstanceCount += instanceCount;
+	m_Dirty = true;
+
+	return baseInstance;
+}
+
+void IndirectBuffer::Clear()
+{
+	m_Commands.clear();
+	m_InstanceCount = 0;
+	m_Dirty = true;
+}
+
+void IndirectBuffer::Upload()
+{
+	if (!m_Dirty)
+		return;
+
+	Bind();
+	unsigned int size = (unsigned int)(m_Commands.size() * sizeof(DrawElementsIndirectCommand));
+	if (m_Commands.size() > m_Capacity)
+	{
+		/* Grow geometrically so a slowly growing scene does not reallocate every frame */
+		m_Capacity = std::max(m_Capacity, 1u);
+		while (m_Capacity < m_Commands.size())
+			m_Capacity *= 2;
+		GLCall(glBufferData(GL_DRAW_INDIRECT_BUFFER, m_Capacity * sizeof(DrawElementsIndirectCommand), nullptr, GL_DYNAMIC_DRAW));
+	}
+	GLCall(glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, size, m_Commands.data()));
+
+	m_Dirty = false;
+}
+
+void IndirectBuffer::Bind() const
+{
+	GLState::Get().BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+}
+
+void IndirectBuffer::UnBind() const
+{
+	GLState::Get().BindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+
+/* Layout mandated by glMultiDrawElementsIndirect */
+struct DrawElementsIndirectCommand
+{
+	unsigned int Count;
+	unsigned int InstanceCount;
+	unsigned int FirstIndex;
+	int BaseVertex;
+	unsigned int BaseInstance;
+};
+
+/*
+ * CPU array of indirect draw commands mirrored into a GL_DRAW_INDIRECT_BUFFER.
+ * Each draw gets a BaseInstance equal to the running instance total, so an
+ * attribute with divisor 1 (or gl_BaseInstance / gl_DrawID where
+ * ARB_shader_draw_parameters exists) can fetch per-draw data.
+ */
+class IndirectBuffer
+{
+private:
+	unsigned int m_RendererID;
+	unsigned int m_Capacity;
+	unsigned int m_InstanceCount;
+	bool m_Dirty;
+	std::vector<DrawElementsIndirectCommand> m_Commands;
+public:
+	IndirectBuffer(unsigned int capacity = 256);
+	~IndirectBuffer();
+
+	/* Returns the BaseInstance assigned to the draw */
+	unsigned int AddDraw(unsigned int count, unsigned int firstIndex, int baseVertex, unsigned int instanceCount = 1);
+	void Clear();
+
+	/* Uploads the commands if they changed since the last upload */
+	void Upload();
+
+	void Bind() const;
+	void UnBind() const;
+
+	inline unsigned int GetCount() const { return (unsigned int)m_Commands.size(); }
+	inline const std::vector<DrawElementsIndirectCommand>& GetCommands() const { return m_Commands; }
+};
\ No newline at end of file
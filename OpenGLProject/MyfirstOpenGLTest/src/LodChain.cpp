@@ -0,0 +1,76 @@
+#include "LodChain.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+
+LodChain LodChain::Build(std::vector<unsigned int>& indices, const float* positions, unsigned int vertexCount, unsigned int vertexStride,
+	unsigned int maxLevels /*= 6*/, float reduction /*= 0.5f*/,
+	const float* attributes /*= nullptr*/, unsigned int attributeCount /*= 0*/, float attributeWeight /*= 1.0f*/)
+{
+	LodChain chain;
+	unsigned int fullCount = (unsigned int)indices.size();
+	chain.m_Levels.push_back({ 0, fullCount, 0.0f });
+
+	/* Every level starts from the full mesh so its error is measured against it, not against the previous level */
+	std::vector<unsigned int> simplified(fullCount);
+	std::vector<unsigned int> optimized(fullCount);
+	float target = (float)fullCount;
+
+	for (unsigned int level = 1; level < maxLevels; level++)
+	{
+		target *= reduction;
+		unsigned int targetCount = (unsigned int)target / 3 * 3;
+
+		float error = 0.0f;
+		unsigned int count = MeshSimplifier::Simplify(simplified.data(), indices.data(), fullCount, positions, vertexCount, vertexStride,
+			targetCount, &error, attributes, attributeCount, attributeWeight);
+
+		/* Locked borders and seams stop the simplifier, a level that barely shrank is not worth its memory */
+		const Level& previous = chain.m_Levels.back();
+		if (count == 0 || count > previous.IndexCount * 0.9f)
+			break;
+
+		MeshOptimizer::OptimizeVertexCache(optimized.data(), simplified.data(), count, vertexCount);
+		chain.m_Levels.push_back({ (unsigned int)indices.size(), count, std::max(error, previous.Error) });
+		indices.insert(indices.end(), optimized.begin(), optimized.begin() + count);
+	}
+
+	return chain;
+}
+
+unsigned int LodChain::Select(float pixelsPerUnit, unsigned int current, float maxPixelError /*= 1.0f*/, float hysteresis /*= 0.25f*/) const
+{
+	current = std::min(current, GetLevelCount() - 1);
+
+	/* Errors grow with the level, so the last level within the limit is the coarsest */
+	auto getCoarsest = [&](float limit)
+	{
+		unsigned int coarsest = 0;
+		for (unsigned int level = 1; level < m_Levels.size(); level++)
+		{
+			if (m_Levels[level].Error * pixelsPerUnit <= limit)
+				coarsest = level;
+		}
+		return coarsest;
+	};
+
+	unsigned int desired = getCoarsest(maxPixelError);
+
+	/* Coarser only once the coarser level is comfortably below the threshold */
+	if (desired > current)
+		return std::max(current, getCoarsest(maxPixelError * (1.0f - hysteresis)));
+
+	/* Finer only once the current level is comfortably above it */
+	if (desired < current && m_Levels[current].Error * pixelsPerUnit > maxPixelError * (1.0f + hysteresis))
+		return desired;
+
+	return current;
+}
+
+float LodChain::GetPixelsPerUnit(float distance, float fovY, float viewportHeight)
+{
+	return viewportHeight / (2.0f * std::max(distance, 1e-6f) * std::tan(fovY * 0.5f));
+}
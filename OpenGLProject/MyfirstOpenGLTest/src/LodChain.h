@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+/*
+ * Levels of detail of one mesh. Every level indexes the same vertex buffer
+ * and owns a range of one shared index buffer, so switching level only
+ * changes the range passed to the draw. Error is the object space distance
+ * the level may deviate from the full mesh.
+ */
+class LodChain
+{
+public:
+	struct Level
+	{
+		unsigned int FirstIndex;
+		unsigned int IndexCount;
+		float Error;
+	};
+
+	/*
+	 * Appends levels simplified from the full mesh in indices (level 0) until
+	 * maxLevels exist or simplification stalls; level i keeps about reduction^i
+	 * of the triangles. Each level is vertex cache optimized. On return indices
+	 * holds every level back to back, ready for one IndexBuffer.
+	 */
+	static LodChain Build(std::vector<unsigned int>& indices, const float* positions, unsigned int vertexCount, unsigned int vertexStride,
+		unsigned int maxLevels = 6, float reduction = 0.5f,
+		const float* attributes = nullptr, unsigned int attributeCount = 0, float attributeWeight = 1.0f);
+
+	/*
+	 * Coarsest level whose error projects to at most maxPixelError pixels.
+	 * With hysteresis the answer only moves away from current once the error
+	 * is clearly past the threshold, so objects near a switching distance do
+	 * not flicker between levels. Callers keep current per object.
+	 */
+	unsigned int Select(float pixelsPerUnit, unsigned int current, float maxPixelError = 1.0f, float hysteresis = 0.25f) const;
+
+	/* Screen pixels covered by one object space unit at distance, for a perspective projection */
+	static float GetPixelsPerUnit(float distance, float fovY, float viewportHeight);
+
+	inline const Level& GetLevel(unsigned int level) const { return m_Levels[level]; }
+	inline unsigned int GetLevelCount() const { return (unsigned int)m_Levels.size(); }
+private:
+	std::vector<Level> m_Levels;
+};
\ No newline at end of file
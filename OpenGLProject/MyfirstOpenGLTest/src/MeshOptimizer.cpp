@@ -0,0 +1,322 @@
+#include "MeshOptimizer.h"
+#include "Renderer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "glm/glm.hpp"
+
+/*
+ * FIFO post-transform cache. A vertex is cached if fewer than cacheSize
+ * vertices were inserted after it; jumping the clock by cacheSize + 1 empties it.
+ */
+class VertexCache
+{
+public:
+	VertexCache(unsigned int vertexCount, unsigned int cacheSize)
+		: m_Times(vertexCount, 0), m_Size(cacheSize), m_Time(cacheSize + 1) {}
+
+	inline bool Contains(unsigned int vertex) const { return m_Time - m_Times[vertex] <= m_Size; }
+	inline unsigned int Age(unsigned int vertex) const { return m_Time - m_Times[vertex]; }
+
+	/* Returns 1 on a miss, which inserts the vertex */
+	inline unsigned int Touch(unsigned int vertex)
+	{
+		if (Contains(vertex))
+			return 0;
+
+		m_Times[vertex] = m_Time++;
+		return 1;
+	}
+
+	inline void Clear() { m_Time += m_Size + 1; }
+private:
+	std::vector<unsigned int> m_Times;
+	unsigned int m_Size;
+	unsigned int m_Time;
+};
+
+MeshOptimizer::VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount,
+	unsigned int cacheSize /*= DefaultCacheSize*/)
+{
+	ASSERT(indexCount % 3 == 0);
+
+	VertexCache cache(vertexCount, cacheSize);
+	std::vector<char> referenced(vertexCount, 0);
+	unsigned int uniqueVertices = 0;
+
+	VertexCacheStats stats;
+	for (unsigned int i = 0; i < indexCount; i++)
+	{
+		unsigned int vertex = indices[i];
+		if (!referenced[vertex])
+		{
+			referenced[vertex] = 1;
+			uniqueVertices++;
+		}
+
+		stats.Transforms += cache.Touch(vertex);
+	}
+
+	stats.ACMR = indexCount ? (float)stats.Transforms / (indexCount / 3) : 0.0f;
+	stats.ATVR = uniqueVertices ? (float)stats.Transforms / uniqueVertices : 0.0f;
+	return stats;
+}
+
+void MeshOptimizer::OptimizeVertexCache(unsigned int* destination, const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount,
+	unsigned int cacheSize /*= DefaultCacheSize*/)
+{
+	ASSERT(indexCount % 3 == 0 && destination != indices);
+
+	/* Triangles around each vertex, and how many of them are not emitted yet */
+	std::vector<unsigned int> live(vertexCount, 0);
+	for (unsigned int i = 0; i < indexCount; i++)
+		live[indices[i]]++;
+
+	std::vector<unsigned int> offsets(vertexCount + 1, 0);
+	for (unsigned int v = 0; v < vertexCount; v++)
+		offsets[v + 1] = offsets[v] + live[v];
+
+	std::vector<unsigned int> adjacency(indexCount);
+	std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+	for (unsigned int i = 0; i < indexCount; i++)
+		adjacency[fill[indices[i]]++] = i / 3;
+
+	std::vector<char> emitted(indexCount / 3, 0);
+	std::vector<unsigned int> deadEnds;
+	std::vector<unsigned int> candidates;
+	VertexCache cache(vertexCount, cacheSize);
+	unsigned int cursor = 0;
+	unsigned int output = 0;
+
+	/* Next vertex with triangles left: the most recently used one still pending, otherwise the next one in input order */
+	auto skipDeadEnd = [&]() -> int
+	{
+		while (!deadEnds.empty())
+		{
+			unsigned int vertex = deadEnds.back();
+			deadEnds.pop_back();
+			if (live[vertex] > 0)
+				return (int)vertex;
+		}
+
+		for (; cursor < vertexCount; cursor++)
+		{
+			if (live[cursor] > 0)
+				return (int)cursor;
+		}
+
+		return -1;
+	};
+
+	int fanning = skipDeadEnd();
+	while (fanning >= 0)
+	{
+		/* Emit every remaining triangle around the fanning vertex */
+		candidates.clear();
+		for (unsigned int a = offsets[fanning]; a < offsets[fanning + 1]; a++)
+		{
+			unsigned int triangle = adjacency[a];
+			if (emitted[triangle])
+				continue;
+
+			for (unsigned int k = 0; k < 3; k++)
+			{
+				unsigned int vertex = indices[triangle * 3 + k];
+				destination[output++] = vertex;
+				deadEnds.push_back(vertex);
+				candidates.push_back(vertex);
+				live[vertex]--;
+				cache.Touch(vertex);
+			}
+			emitted[triangle] = 1;
+		}
+
+		/* Prefer the oldest candidate that stays cached while its own fan is emitted */
+		int next = -1;
+		int bestPriority = -1;
+		for (unsigned int vertex : candidates)
+		{
+			if (live[vertex] == 0)
+				continue;
+
+			int priority = 0;
+			if (cache.Age(vertex) + 2 * live[vertex] <= cacheSize)
+				priority = (int)cache.Age(vertex);
+
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				next = (int)vertex;
+			}
+		}
+
+		fanning = next >= 0 ? next : skipDeadEnd();
+	}
+
+	ASSERT(output == indexCount);
+}
+
+void MeshOptimizer::OptimizeOverdraw(unsigned int* destination, const unsigned int* indices, unsigned int indexCount,
+	const float* positions, unsigned int vertexCount, unsigned int positionStride, float threshold /*= 1.05f*/,
+	unsigned int cacheSize /*= DefaultCacheSize*/)
+{
+	ASSERT(indexCount % 3 == 0 && destination != indices);
+
+	unsigned int triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return;
+
+	auto getMisses = [&](VertexCache& cache, unsigned int triangle)
+	{
+		return cache.Touch(indices[triangle * 3 + 0]) + cache.Touch(indices[triangle * 3 + 1]) + cache.Touch(indices[triangle * 3 + 2]);
+	};
+
+	/* Hard boundaries: triangles that miss on all three vertices start over anyway, cutting there is free */
+	VertexCache cache(vertexCount, cacheSize);
+	std::vector<unsigned int> hardBoundaries;
+	for (unsigned int t = 0; t < triangleCount; t++)
+	{
+		if (getMisses(cache, t) == 3 || t == 0)
+			hardBoundaries.push_back(t);
+	}
+	hardBoundaries.push_back(triangleCount);
+
+	/* Soft boundaries: cut as soon as the piece so far, drawn from a cold cache, is within threshold of the whole run */
+	std::vector<unsigned int> clusters;
+	for (unsigned int h = 0; h + 1 < hardBoundaries.size(); h++)
+	{
+		unsigned int begin = hardBoundaries[h];
+		unsigned int end = hardBoundaries[h + 1];
+
+		cache.Clear();
+		unsigned int runMisses = 0;
+		for (unsigned int t = begin; t < end; t++)
+			runMisses += getMisses(cache, t);
+		float runACMR = (float)runMisses / (end - begin);
+
+		cache.Clear();
+		unsigned int start = begin;
+		unsigned int misses = 0;
+		clusters.push_back(begin);
+		for (unsigned int t = begin; t < end; t++)
+		{
+			misses += getMisses(cache, t);
+			if (t + 1 < end && misses <= runACMR * threshold * (t + 1 - start))
+			{
+				clusters.push_back(t + 1);
+				cache.Clear();
+				start = t + 1;
+				misses = 0;
+			}
+		}
+	}
+	clusters.push_back(triangleCount);
+
+	auto getPosition = [&](unsigned int vertex)
+	{
+		const float* p = (const float*)((const char*)positions + (size_t)vertex * positionStride);
+		return glm::vec3(p[0], p[1], p[2]);
+	};
+
+	/* Area weighted centroid and normal of every cluster, and the centroid of the mesh */
+	unsigned int clusterCount = (unsigned int)clusters.size() - 1;
+	std::vector<glm::vec3> centroids(clusterCount, glm::vec3(0.0f));
+	std::vector<glm::vec3> normals(clusterCount, glm::vec3(0.0f));
+	glm::vec3 meshCentroid(0.0f);
+	float meshArea = 0.0f;
+
+	for (unsigned int c = 0; c < clusterCount; c++)
+	{
+		float clusterArea = 0.0f;
+		for (unsigned int t = clusters[c]; t < clusters[c + 1]; t++)
+		{
+			glm::vec3 p0 = getPosition(indices[t * 3 + 0]);
+			glm::vec3 p1 = getPosition(indices[t * 3 + 1]);
+			glm::vec3 p2 = getPosition(indices[t * 3 + 2]);
+
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			float area = glm::length(normal);
+
+			centroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+			normals[c] += normal;
+			clusterArea += area;
+		}
+
+		meshCentroid += centroids[c];
+		meshArea += clusterArea;
+		if (clusterArea > 0.0f)
+			centroids[c] /= clusterArea;
+	}
+	if (meshArea > 0.0f)
+		meshCentroid /= meshArea;
+
+	/* Clusters facing away from the centre are on the outside and likely occlude the rest, draw them first */
+	std::vector<float> keys(clusterCount);
+	for (unsigned int c = 0; c < clusterCount; c++)
+	{
+		float length = glm::length(normals[c]);
+		keys[c] = length > 0.0f ? glm::dot(centroids[c] - meshCentroid, normals[c] / length) : 0.0f;
+	}
+
+	std::vector<unsigned int> order(clusterCount);
+	for (unsigned int c = 0; c < clusterCount; c++)
+		order[c] = c;
+	std::stable_sort(order.begin(), order.end(), [&keys](unsigned int a, unsigned int b) { return keys[a] > keys[b]; });
+
+	unsigned int output = 0;
+	for (unsigned int c : order)
+	{
+		unsigned int count = (clusters[c + 1] - clusters[c]) * 3;
+		memcpy(destination + output, indices + clusters[c] * 3, count * sizeof(unsigned int));
+		output += count;
+	}
+}
+
+unsigned int MeshOptimizer::OptimizeVertexFetch(void* destination, unsigned int* indices, unsigned int indexCount,
+	const void* vertices, unsigned int vertexCount, unsigned int vertexSize)
+{
+	ASSERT(destination != vertices);
+
+	const unsigned int Unused = 0xffffffff;
+	std::vector<unsigned int> remap(vertexCount, Unused);
+	unsigned int next = 0;
+
+	for (unsigned int i = 0; i < indexCount; i++)
+	{
+		unsigned int vertex = indices[i];
+		if (remap[vertex] == Unused)
+		{
+			memcpy((char*)destination + (size_t)next * vertexSize, (const char*)vertices + (size_t)vertex * vertexSize, vertexSize);
+			remap[vertex] = next++;
+		}
+
+		indices[i] = remap[vertex];
+	}
+
+	return next;
+}
+
+MeshOptimizer::Report MeshOptimizer::Optimize(std::vector<unsigned int>& indices, std::vector<char>& vertices, unsigned int vertexSize,
+	unsigned int positionOffset /*= 0*/)
+{
+	unsigned int indexCount = (unsigned int)indices.size();
+	unsigned int vertexCount = (unsigned int)(vertices.size() / vertexSize);
+
+	Report report;
+	report.Before = AnalyzeVertexCache(indices.data(), indexCount, vertexCount);
+	report.VerticesBefore = vertexCount;
+
+	std::vector<unsigned int> cacheOrder(indexCount);
+	OptimizeVertexCache(cacheOrder.data(), indices.data(), indexCount, vertexCount);
+	OptimizeOverdraw(indices.data(), cacheOrder.data(), indexCount, (const float*)(vertices.data() + positionOffset), vertexCount, vertexSize);
+
+	std::vector<char> fetchOrder(vertices.size());
+	unsigned int used = OptimizeVertexFetch(fetchOrder.data(), indices.data(), indexCount, vertices.data(), vertexCount, vertexSize);
+	fetchOrder.resize((size_t)used * vertexSize);
+	vertices.swap(fetchOrder);
+
+	report.After = AnalyzeVertexCache(indices.data(), indexCount, used);
+	report.VerticesAfter = used;
+	return report;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+/*
+ * CPU passes over indexed triangle lists, meant to run once when a mesh is
+ * built or loaded, before its IndexBuffer and VertexBuffer are created.
+ *
+ *   OptimizeVertexCache  Tipsify (Sander, Nehab, Barczak 2007): orders triangles so
+ *                        vertices are reused while still in the post-transform cache
+ *   OptimizeOverdraw     cuts that order into clusters where it costs little cache
+ *                        efficiency and draws the most outward facing clusters first
+ *   OptimizeVertexFetch  renumbers vertices in order of first use so vertex fetch walks
+ *                        the vertex buffer front to back
+ *
+ * AnalyzeVertexCache simulates a FIFO post-transform cache, so the gain can be
+ * measured without a GPU.
+ */
+namespace MeshOptimizer
+{
+	static const unsigned int DefaultCacheSize = 16;
+
+	struct VertexCacheStats
+	{
+		/* Vertex shader invocations, i.e. cache misses */
+		unsigned int Transforms = 0;
+		/* Transforms per triangle: 3 is the worst case, about 0.5 the best for large regular meshes */
+		float ACMR = 0.0f;
+		/* Transforms per referenced vertex: 1 is the best case */
+		float ATVR = 0.0f;
+	};
+
+	struct Report
+	{
+		VertexCacheStats Before;
+		VertexCacheStats After;
+		unsigned int VerticesBefore = 0;
+		unsigned int VerticesAfter = 0;
+	};
+
+	VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount,
+		unsigned int cacheSize = DefaultCacheSize);
+
+	/* destination must not alias indices */
+	void OptimizeVertexCache(unsigned int* destination, const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount,
+		unsigned int cacheSize = DefaultCacheSize);
+
+	/*
+	 * indices should already be cache optimized. positions points at the first
+	 * vertex's float3 position, positionStride is the vertex size in bytes.
+	 * threshold is the ACMR increase accepted for a cut, 1.05 allows 5%.
+	 * destination must not alias indices.
+	 */
+	void OptimizeOverdraw(unsigned int* destination, const unsigned int* indices, unsigned int indexCount,
+		const float* positions, unsigned int vertexCount, unsigned int positionStride, float threshold = 1.05f,
+		unsigned int cacheSize = DefaultCacheSize);
+
+	/* Writes the used vertices to destination in order of first use and rewrites indices in place, returns their count */
+	unsigned int OptimizeVertexFetch(void* destination, unsigned int* indices, unsigned int indexCount,
+		const void* vertices, unsigned int vertexCount, unsigned int vertexSize);
+
+	/* Runs all three passes; vertices holds vertexSize-byte vertices with a float3 position at positionOffset */
+	Report Optimize(std::vector<unsigned int>& indices, std::vector<char>& vertices, unsigned int vertexSize, unsigned int positionOffset = 0);
+}
\ No newline at end of file
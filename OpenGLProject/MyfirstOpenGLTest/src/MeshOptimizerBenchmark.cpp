@@ -0,0 +1,79 @@
+#include "MeshOptimizerBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "MeshOptimizer.h"
+#include "VertexQuantizer.h"
+#include "SphereMesh.h"
+
+static double NowMs()
+{
+	using namespace std::chrono;
+	return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+void RunMeshOptimizerBenchmark(unsigned int segments /*= 256*/)
+{
+	std::vector<SphereVertex> vertices;
+	std::vector<unsigned int> triangles;
+	BuildSphere(segments, vertices, triangles);
+
+	/* Shuffle whole triangles, keeping their winding */
+	std::vector<unsigned int> order(triangles.size() / 3);
+	for (unsigned int t = 0; t < order.size(); t++)
+		order[t] = t;
+	std::shuffle(order.begin(), order.end(), std::mt19937(1234));
+
+	std::vector<unsigned int> indices;
+	for (unsigned int t : order)
+		indices.insert(indices.end(), { triangles[t * 3 + 0], triangles[t * 3 + 1], triangles[t * 3 + 2] });
+
+	unsigned int indexCount = (unsigned int)indices.size();
+	unsigned int vertexCount = (unsigned int)vertices.size();
+
+	auto print = [&](const char* pass, const std::vector<unsigned int>& data, unsigned int referencedVertices, double ms)
+	{
+		MeshOptimizer::VertexCacheStats stats = MeshOptimizer::AnalyzeVertexCache(data.data(), indexCount, referencedVertices);
+		std::cout << pass << "\t" << stats.ACMR << "\t" << stats.ATVR << "\t" << ms << std::endl;
+	};
+
+	std::cout << vertexCount << " vertices, " << indexCount / 3 << " triangles, FIFO cache of "
+		<< MeshOptimizer::DefaultCacheSize << std::endl;
+	std::cout << "pass\tACMR\tATVR\tms" << std::endl;
+	print("grid order", triangles, vertexCount, 0.0);
+	print("shuffled", indices, vertexCount, 0.0);
+
+	std::vector<unsigned int> cacheOrder(indexCount);
+	double start = NowMs();
+	MeshOptimizer::OptimizeVertexCache(cacheOrder.data(), indices.data(), indexCount, vertexCount);
+	print("tipsify", cacheOrder, vertexCount, NowMs() - start);
+
+	start = NowMs();
+	MeshOptimizer::OptimizeOverdraw(indices.data(), cacheOrder.data(), indexCount, vertices[0].Position, vertexCount, (unsigned int)sizeof(SphereVertex));
+	print("overdraw", indices, vertexCount, NowMs() - start);
+
+	std::vector<SphereVertex> fetchOrder(vertexCount);
+	start = NowMs();
+	unsigned int used = MeshOptimizer::OptimizeVertexFetch(fetchOrder.data(), indices.data(), indexCount, vertices.data(), vertexCount, (unsigned int)sizeof(SphereVertex));
+	print("fetch remap", indices, used, NowMs() - start);
+
+	VertexQuantizer::Attributes attributes;
+	attributes.Position = (int)offsetof(SphereVertex, Position);
+	attributes.TexCoord = (int)offsetof(SphereVertex, TexCoord);
+	attributes.Normal = (int)offsetof(SphereVertex, Normal);
+
+	start = NowMs();
+	VertexQuantizer::Mesh packed = VertexQuantizer::Quantize(fetchOrder.data(), used, (unsigned int)sizeof(SphereVertex), attributes);
+	double quantizeMs = NowMs() - start;
+
+	const VertexQuantizer::Report& report = packed.Stats;
+	std::cout << "quantize: " << report.SourceBytes << " -> " << report.PackedBytes << " bytes ("
+		<< report.GetSavedFraction() * 100.0f << "% saved) in " << quantizeMs << " ms" << std::endl;
+	std::cout << "max error: position " << report.MaxPositionError << ", texCoord " << report.MaxTexCoordError
+		<< ", normal " << report.MaxNormalError << " degrees" << std::endl;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+/*
+ * Builds a UV sphere of segments x segments quads, shuffles its triangles to
+ * stand in for a mesh with arbitrary triangle order, runs the MeshOptimizer
+ * passes on it and prints ACMR/ATVR and the time of each pass. Then packs the
+ * vertices with VertexQuantizer and prints the memory saved. Needs no GL.
+ */
+void RunMeshOptimizerBenchmark(unsigned int segments = 256);
\ No newline at end of file
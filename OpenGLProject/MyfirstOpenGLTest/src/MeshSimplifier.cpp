@@ -0,0 +1,359 @@
+#include "MeshSimplifier.h"
+#include "Renderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+/* Area weighted sum of squared distances to a set of planes */
+struct Quadric
+{
+	double A00 = 0, A01 = 0, A02 = 0, A11 = 0, A12 = 0, A22 = 0;
+	double B0 = 0, B1 = 0, B2 = 0;
+	double C = 0;
+	double Weight = 0;
+
+	void AddPlane(const glm::dvec3& normal, double distance, double weight)
+	{
+		A00 += weight * normal.x * normal.x;
+		A01 += weight * normal.x * normal.y;
+		A02 += weight * normal.x * normal.z;
+		A11 += weight * normal.y * normal.y;
+		A12 += weight * normal.y * normal.z;
+		A22 += weight * normal.z * normal.z;
+		B0 += weight * normal.x * distance;
+		B1 += weight * normal.y * distance;
+		B2 += weight * normal.z * distance;
+		C += weight * distance * distance;
+		Weight += weight;
+	}
+
+	void Add(const Quadric& other)
+	{
+		A00 += other.A00; A01 += other.A01; A02 += other.A02;
+		A11 += other.A11; A12 += other.A12; A22 += other.A22;
+		B0 += other.B0; B1 += other.B1; B2 += other.B2;
+		C += other.C;
+		Weight += other.Weight;
+	}
+
+	/* Mean squared distance of p to the planes */
+	double Evaluate(const glm::dvec3& p) const
+	{
+		double error = A00 * p.x * p.x + A11 * p.y * p.y + A22 * p.z * p.z
+			+ 2.0 * (A01 * p.x * p.y + A02 * p.x * p.z + A12 * p.y * p.z)
+			+ 2.0 * (B0 * p.x + B1 * p.y + B2 * p.z) + C;
+		return Weight > 0.0 ? std::max(error, 0.0) / Weight : 0.0;
+	}
+};
+
+/* Closest point to p on the triangle abc (Ericson, Real-Time Collision Detection 5.1.5) */
+static glm::dvec3 ClosestPointOnTriangle(const glm::dvec3& p, const glm::dvec3& a, const glm::dvec3& b, const glm::dvec3& c)
+{
+	glm::dvec3 ab = b - a, ac = c - a, ap = p - a;
+	double d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+	if (d1 <= 0.0 && d2 <= 0.0)
+		return a;
+
+	glm::dvec3 bp = p - b;
+	double d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+	if (d3 >= 0.0 && d4 <= d3)
+		return b;
+
+	double vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+		return a + ab * (d1 / (d1 - d3));
+
+	glm::dvec3 cp = p - c;
+	double d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+	if (d6 >= 0.0 && d5 <= d6)
+		return c;
+
+	double vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+		return a + ac * (d2 / (d2 - d6));
+
+	double va = d3 * d6 - d5 * d4;
+	if (va <= 0.0 && d4 - d3 >= 0.0 && d5 - d6 >= 0.0)
+		return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+	double denominator = 1.0 / (va + vb + vc);
+	return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+struct Collapse
+{
+	unsigned int From;
+	unsigned int To;
+	double Cost;
+};
+
+struct PositionHash
+{
+	size_t operator()(const glm::vec3& p) const
+	{
+		unsigned int bits[3];
+		memcpy(bits, &p, sizeof(bits));
+		return (size_t)(bits[0] * 73856093u ^ bits[1] * 19349663u ^ bits[2] * 83492791u);
+	}
+};
+
+unsigned int MeshSimplifier::Simplify(unsigned int* destination, const unsigned int* indices, unsigned int indexCount,
+	const float* positions, unsigned int vertexCount, unsigned int vertexStride, unsigned int targetIndexCount,
+	float* error /*= nullptr*/, const float* attributes /*= nullptr*/, unsigned int attributeCount /*= 0*/, float attributeWeight /*= 1.0f*/)
+{
+	ASSERT(indexCount % 3 == 0);
+
+	auto getPosition = [&](unsigned int vertex)
+	{
+		const float* p = (const float*)((const char*)positions + (size_t)vertex * vertexStride);
+		return glm::dvec3(p[0], p[1], p[2]);
+	};
+
+	auto getAttributeError = [&](unsigned int a, unsigned int b)
+	{
+		const float* first = (const float*)((const char*)attributes + (size_t)a * vertexStride);
+		const float* second = (const float*)((const char*)attributes + (size_t)b * vertexStride);
+		double sum = 0.0;
+		for (unsigned int k = 0; k < attributeCount; k++)
+			sum += (double)(first[k] - second[k]) * (first[k] - second[k]);
+		return sum * attributeWeight;
+	};
+
+	std::vector<unsigned int> current(indices, indices + indexCount);
+
+	/* Seams: a position shared by several vertices */
+	std::vector<char> locked(vertexCount, 0);
+	{
+		std::unordered_map<glm::vec3, unsigned int, PositionHash> firstAtPosition;
+		for (unsigned int v = 0; v < vertexCount; v++)
+		{
+			/* Adding zero turns -0 into +0 so both hash alike */
+			glm::vec3 p = glm::vec3(getPosition(v)) + glm::vec3(0.0f);
+			auto inserted = firstAtPosition.insert({ p, v });
+			if (!inserted.second)
+			{
+				locked[v] = 1;
+				locked[inserted.first->second] = 1;
+			}
+		}
+	}
+
+	/* Borders: an edge without its opposite half-edge */
+	{
+		std::unordered_set<uint64_t> halfEdges;
+		for (unsigned int i = 0; i < indexCount; i += 3)
+		{
+			for (unsigned int k = 0; k < 3; k++)
+				halfEdges.insert((uint64_t)current[i + k] << 32 | current[i + (k + 1) % 3]);
+		}
+
+		for (unsigned int i = 0; i < indexCount; i += 3)
+		{
+			for (unsigned int k = 0; k < 3; k++)
+			{
+				unsigned int a = current[i + k];
+				unsigned int b = current[i + (k + 1) % 3];
+				if (!halfEdges.count((uint64_t)b << 32 | a))
+					locked[a] = locked[b] = 1;
+			}
+		}
+	}
+
+	std::vector<Quadric> quadrics(vertexCount);
+	for (unsigned int i = 0; i < indexCount; i += 3)
+	{
+		glm::dvec3 p0 = getPosition(current[i + 0]);
+		glm::dvec3 normal = glm::cross(getPosition(current[i + 1]) - p0, getPosition(current[i + 2]) - p0);
+		double length = glm::length(normal);
+		if (length == 0.0)
+			continue;
+
+		normal /= length;
+		for (unsigned int k = 0; k < 3; k++)
+			quadrics[current[i + k]].AddPlane(normal, -glm::dot(normal, p0), length * 0.5);
+	}
+
+	/* offsets[v] .. offsets[v + 1] index the triangles around v in adjacency */
+	std::vector<unsigned int> offsets(vertexCount + 1);
+	std::vector<unsigned int> adjacency;
+	auto buildAdjacency = [&]()
+	{
+		std::fill(offsets.begin(), offsets.end(), 0);
+		for (unsigned int vertex : current)
+			offsets[vertex + 1]++;
+		for (unsigned int v = 0; v < vertexCount; v++)
+			offsets[v + 1] += offsets[v];
+		adjacency.resize(current.size());
+		std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+		for (unsigned int i = 0; i < current.size(); i++)
+			adjacency[fill[current[i]]++] = i / 3;
+	};
+
+	std::vector<Collapse> collapses;
+	std::vector<unsigned int> remap(vertexCount);
+	std::vector<char> dirty(vertexCount);
+	/* The vertex each original vertex ended up merged into */
+	std::vector<unsigned int> representative(vertexCount);
+	for (unsigned int v = 0; v < vertexCount; v++)
+		representative[v] = v;
+
+	/* Collapsing from onto to must not turn any remaining triangle around from over */
+	auto flips = [&](unsigned int from, unsigned int to)
+	{
+		glm::dvec3 target = getPosition(to);
+		for (unsigned int a = offsets[from]; a < offsets[from + 1]; a++)
+		{
+			const unsigned int* triangle = &current[adjacency[a] * 3];
+			if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+				continue;
+
+			glm::dvec3 p[3];
+			glm::dvec3 moved[3];
+			for (unsigned int k = 0; k < 3; k++)
+			{
+				p[k] = getPosition(triangle[k]);
+				moved[k] = triangle[k] == from ? target : p[k];
+			}
+
+			glm::dvec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+			glm::dvec3 after = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+			if (glm::dot(before, after) < 0.25 * glm::length(before) * glm::length(after))
+				return true;
+		}
+		return false;
+	};
+
+	/* Each pass ranks every edge and collapses the cheapest ones that do not touch each other */
+	while (current.size() > targetIndexCount)
+	{
+		unsigned int triangleCount = (unsigned int)current.size() / 3;
+		buildAdjacency();
+
+		collapses.clear();
+		for (unsigned int i = 0; i < current.size(); i += 3)
+		{
+			for (unsigned int k = 0; k < 3; k++)
+			{
+				unsigned int a = current[i + k];
+				unsigned int b = current[i + (k + 1) % 3];
+				/* Interior edges show up once in each direction, only take one of them */
+				if (a > b || (locked[a] && locked[b]))
+					continue;
+
+				Collapse best = { 0, 0, 0.0 };
+				bool found = false;
+				for (unsigned int direction = 0; direction < 2; direction++)
+				{
+					unsigned int from = direction ? b : a;
+					unsigned int to = direction ? a : b;
+					if (locked[from])
+						continue;
+
+					double cost = quadrics[from].Evaluate(getPosition(to)) + (attributes ? getAttributeError(from, to) : 0.0);
+					if (!found || cost < best.Cost)
+					{
+						best = { from, to, cost };
+						found = true;
+					}
+				}
+
+				if (found)
+					collapses.push_back(best);
+			}
+		}
+
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y) { return x.Cost < y.Cost; });
+
+		for (unsigned int v = 0; v < vertexCount; v++)
+			remap[v] = v;
+		std::fill(dirty.begin(), dirty.end(), 0);
+
+		unsigned int toRemove = (triangleCount - targetIndexCount / 3);
+		unsigned int removed = 0;
+		unsigned int applied = 0;
+		for (const Collapse& collapse : collapses)
+		{
+			if (dirty[collapse.From] || dirty[collapse.To] || flips(collapse.From, collapse.To))
+				continue;
+
+			/* The triangles around From change, keep every vertex on them out of this pass */
+			for (unsigned int a = offsets[collapse.From]; a < offsets[collapse.From + 1]; a++)
+			{
+				const unsigned int* triangle = &current[adjacency[a] * 3];
+				if (triangle[0] == collapse.To || triangle[1] == collapse.To || triangle[2] == collapse.To)
+					removed++;
+				for (unsigned int k = 0; k < 3; k++)
+					dirty[triangle[k]] = 1;
+			}
+
+			remap[collapse.From] = collapse.To;
+			quadrics[collapse.To].Add(quadrics[collapse.From]);
+			applied++;
+
+			if (removed >= toRemove)
+				break;
+		}
+
+		if (applied == 0)
+			break;
+
+		for (unsigned int v = 0; v < vertexCount; v++)
+			representative[v] = remap[representative[v]];
+
+		unsigned int output = 0;
+		for (unsigned int i = 0; i < current.size(); i += 3)
+		{
+			unsigned int a = remap[current[i + 0]];
+			unsigned int b = remap[current[i + 1]];
+			unsigned int c = remap[current[i + 2]];
+			if (a == b || b == c || a == c)
+				continue;
+
+			current[output++] = a;
+			current[output++] = b;
+			current[output++] = c;
+		}
+		current.resize(output);
+	}
+
+	if (error)
+	{
+		/*
+		 * The merged quadrics rank collapses well but hold planes from all over
+		 * the removed region, so their error grows towards the object's size.
+		 * Measure instead how far each removed vertex lies from the nearest
+		 * simplified triangle around the vertex it was merged into.
+		 */
+		buildAdjacency();
+
+		double maxError = 0.0;
+		for (unsigned int i = 0; i < indexCount; i++)
+		{
+			unsigned int vertex = indices[i];
+			unsigned int target = representative[vertex];
+			if (target == vertex)
+				continue;
+
+			glm::dvec3 p = getPosition(vertex);
+			double nearest = glm::length(p - getPosition(target));
+			for (unsigned int a = offsets[target]; a < offsets[target + 1]; a++)
+			{
+				const unsigned int* triangle = &current[adjacency[a] * 3];
+				glm::dvec3 closest = ClosestPointOnTriangle(p, getPosition(triangle[0]), getPosition(triangle[1]), getPosition(triangle[2]));
+				nearest = std::min(nearest, glm::length(p - closest));
+			}
+			maxError = std::max(maxError, nearest);
+		}
+		*error = (float)maxError;
+	}
+
+	std::copy(current.begin(), current.end(), destination);
+	return (unsigned int)current.size();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+/*
+ * Quadric error metric simplification (Garland and Heckbert 1997) by
+ * half-edge collapse: a vertex is merged into one of its neighbours and never
+ * moved, so every simplified index list still indexes the original vertex
+ * buffer and all LODs of a mesh can share it.
+ *
+ * Vertices on open borders and on attribute seams (several vertices at one
+ * position, e.g. a UV or normal discontinuity) are locked so outlines and
+ * seams survive. The attribute difference between the two ends of a collapse
+ * is added to its cost, so flat regions with changing UVs or colours
+ * simplify last.
+ */
+namespace MeshSimplifier
+{
+	/*
+	 * Simplifies until at most targetIndexCount indices are left or nothing
+	 * more can collapse, and returns the resulting index count. error receives
+	 * the largest distance in object units from an original vertex to the
+	 * simplified triangles around the vertex it was merged into. positions and
+	 * attributes (attributeCount floats each) are read with vertexStride bytes
+	 * between vertices. destination may alias indices.
+	 */
+	unsigned int Simplify(unsigned int* destination, const unsigned int* indices, unsigned int indexCount,
+		const float* positions, unsigned int vertexCount, unsigned int vertexStride, unsigned int targetIndexCount,
+		float* error = nullptr, const float* attributes = nullptr, unsigned int attributeCount = 0, float attributeWeight = 1.0f);
+}
\ No newline at end of file
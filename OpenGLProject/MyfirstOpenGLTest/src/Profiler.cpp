@@ -0,0 +1,149 @@
+#include "Profiler.h"
+
+#include <chrono>
+#include <fstream>
+
+thread_local ProfileRing* Profiler::t_Ring = nullptr;
+
+static int64_t SteadyNs()
+{
+	using namespace std::chrono;
+	return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+Profiler& Profiler::Get()
+{
+	static Profiler s_Profiler;
+	return s_Profiler;
+}
+
+/* Returns the thread's ring to the profiler when the thread exits */
+struct ProfileRingOwner
+{
+	ProfileRing* Ring = nullptr;
+
+	~ProfileRingOwner()
+	{
+		if (Ring)
+		{
+			Profiler::t_Ring = nullptr;
+			Profiler::Get().ReleaseThread(Ring);
+		}
+	}
+};
+
+static std::string EscapeJson(const char* text)
+{
+	std::string escaped;
+	for (const char* c = text; *c; c++)
+	{
+		if (*c == '"' || *c == '\\')
+		{
+			escaped += '\\';
+			escaped += *c;
+		}
+		else if ((unsigned char)*c < 0x20)
+		{
+			/* Control characters are not allowed raw in a JSON string */
+			escaped += ' ';
+		}
+		else
+		{
+			escaped += *c;
+		}
+	}
+	return escaped;
+}
+
+Profiler::Profiler()
+	: m_EpochTicks(Now()), m_EpochNs(SteadyNs()), m_NextThreadID(0)
+{
+}
+
+double Profiler::GetTickRate() const
+{
+	int64_t ticks = Now() - m_EpochTicks;
+	int64_t ns = SteadyNs() - m_EpochNs;
+	return ns > 0 && ticks > 0 ? (double)ticks / ns : 1.0;
+}
+
+ProfileRing* Profiler::RegisterThread()
+{
+	/* t_Ring stays a plain pointer for Record, the owner only exists to see the thread exit */
+	static thread_local ProfileRingOwner s_Owner;
+
+	std::lock_guard<std::mutex> lock(m_RingsMutex);
+	if (m_FreeRings.empty())
+	{
+		m_Rings.push_back(std::make_unique<ProfileRing>(m_NextThreadID));
+		t_Ring = m_Rings.back().get();
+	}
+	else
+	{
+		/* The exited thread's zones are dropped with its ring */
+		t_Ring = m_FreeRings.back();
+		m_FreeRings.pop_back();
+		t_Ring->Head.store(0, std::memory_order_relaxed);
+		t_Ring->ThreadID = m_NextThreadID;
+	}
+
+	m_NextThreadID++;
+	s_Owner.Ring = t_Ring;
+	return t_Ring;
+}
+
+void Profiler::ReleaseThread(ProfileRing* ring)
+{
+	std::lock_guard<std::mutex> lock(m_RingsMutex);
+	m_FreeRings.push_back(ring);
+}
+
+bool Profiler::WriteChromeTrace(const std::string& filepath)
+{
+	std::ofstream stream(filepath);
+	if (!stream)
+		return false;
+
+	stream << "{\"traceEvents\":[";
+	bool first = true;
+	double ticksPerUs = GetTickRate() * 1000.0;
+
+	std::lock_guard<std::mutex> lock(m_RingsMutex);
+	for (const auto& ring : m_Rings)
+	{
+		uint64_t head = ring->Head.load(std::memory_order_acquire);
+		uint64_t begin = head > ProfileRing::Capacity ? head - ProfileRing::Capacity : 0;
+
+		for (uint64_t i = begin; i < head; i++)
+		{
+			const ProfileZone& zone = ring->Zones[i & (ProfileRing::Capacity - 1)];
+
+			/* Complete ("X") events, timestamps in microseconds */
+			stream << (first ? "" : ",") << "\n{\"name\":\"" << EscapeJson(zone.Name) << "\",\"cat\":\"cpu\",\"ph\":\"X\""
+				<< ",\"ts\":" << (zone.Start - m_EpochTicks) / ticksPerUs << ",\"dur\":" << (zone.End - zone.Start) / ticksPerUs
+				<< ",\"pid\":0,\"tid\":" << ring->ThreadID << "}";
+			first = false;
+		}
+	}
+
+	stream << "\n]}\n";
+	return true;
+}
+
+double Profiler::MeasureOverhead(unsigned int iterations /*= 1000000*/)
+{
+	/* Recorded into a ring of its own that is never dumped, the thread's trace stays intact */
+	std::unique_ptr<ProfileRing> scratch = std::make_unique<ProfileRing>(0);
+	ProfileRing* ring = t_Ring;
+	t_Ring = scratch.get();
+
+	int64_t start = Now();
+	for (unsigned int i = 0; i < iterations; i++)
+	{
+		ProfileTimer timer("Profiler::MeasureOverhead");
+	}
+	int64_t end = Now();
+
+	t_Ring = ring;
+	return (end - start) / GetTickRate() / iterations;
+}
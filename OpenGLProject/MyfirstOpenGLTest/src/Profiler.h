@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define PROFILER_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_RDTSC 1
+#else
+#include <chrono>
+#endif
+
+/* Build with PROFILING=0 to compile every PROFILE_SCOPE out */
+#ifndef PROFILING
+#define PROFILING 1
+#endif
+
+/* Zone times are raw ticks, converted to time only when the trace is written */
+struct ProfileZone
+{
+	const char* Name;
+	int64_t Start;
+	int64_t End;
+};
+
+/*
+ * Single-producer ring of finished zones owned by one thread. The owner only
+ * stores the zone and publishes the new head, so recording never locks. Once
+ * full, the oldest zones are overwritten. When the owner exits, the ring is
+ * handed to the next thread that registers.
+ */
+struct ProfileRing
+{
+	static const unsigned int Capacity = 1 << 15;
+
+	ProfileZone Zones[Capacity];
+	std::atomic<uint64_t> Head;
+	unsigned int ThreadID;
+
+	ProfileRing(unsigned int threadID)
+		: Head(0), ThreadID(threadID) {}
+};
+
+/*
+ * CPU zone profiler. PROFILE_SCOPE("Renderer::Draw") times the enclosing
+ * block into the calling thread's ring, WriteChromeTrace dumps every ring as
+ * chrome://tracing / Perfetto JSON.
+ */
+class Profiler
+{
+public:
+	static Profiler& Get();
+
+	/* The TSC where available: a steady_clock read costs more than the whole zone budget */
+	static inline int64_t Now()
+	{
+#if PROFILER_RDTSC
+		return (int64_t)__rdtsc();
+#else
+		return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+	}
+
+	static inline void Record(const char* name, int64_t start, int64_t end)
+	{
+		ProfileRing* ring = t_Ring ? t_Ring : Get().RegisterThread();
+		uint64_t head = ring->Head.load(std::memory_order_relaxed);
+		ring->Zones[head & (ProfileRing::Capacity - 1)] = { name, start, end };
+		ring->Head.store(head + 1, std::memory_order_release);
+	}
+
+	/* Zones still being written while dumping can come out torn, dump between frames */
+	bool WriteChromeTrace(const std::string& filepath);
+
+	/* Average cost of one empty zone in nanoseconds; the zones it times are discarded */
+	double MeasureOverhead(unsigned int iterations = 1000000);
+private:
+	Profiler();
+
+	ProfileRing* RegisterThread();
+	void ReleaseThread(ProfileRing* ring);
+	/* Ticks per nanosecond, measured against steady_clock since construction */
+	double GetTickRate() const;
+private:
+	int64_t m_EpochTicks;
+	int64_t m_EpochNs;
+
+	std::mutex m_RingsMutex;
+	std::vector<std::unique_ptr<ProfileRing>> m_Rings;
+	/* Rings of exited threads, reused before allocating a new one */
+	std::vector<ProfileRing*> m_FreeRings;
+	unsigned int m_NextThreadID;
+
+	static thread_local ProfileRing* t_Ring;
+
+	friend struct ProfileRingOwner;
+};
+
+class ProfileTimer
+{
+private:
+	const char* m_Name;
+	int64_t m_Start;
+public:
+	ProfileTimer(const char* name)
+		: m_Name(name), m_Start(Profiler::Now()) {}
+
+	~ProfileTimer()
+	{
+		Profiler::Record(m_Name, m_Start, Profiler::Now());
+	}
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if PROFILING
+#define PROFILE_SCOPE(name) ProfileTimer PROFILE_CONCAT(profileTimer, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "ProgramCache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include "Renderer.h"
+
+/* File header in front of the blob; bump the version when the layout changes */
+struct ProgramBinaryHeader
+{
+	char Magic[4];
+	unsigned int Version;
+	unsigned int Format;
+	unsigned int Length;
+	/* The file name alone could be a colliding or stale file, Load checks both */
+	unsigned long long Key;
+	unsigned long long DriverHash;
+};
+
+static const unsigned int s_HeaderVersion = 2;
+static const unsigned long long s_FnvOffsetBasis = 14695981039346656037ull;
+
+static unsigned long long HashString(unsigned long long hash, const std::string& value)
+{
+	for (char c : value)
+		hash = (hash ^ (unsigned char)c) * 1099511628211ull;
+	/* A separator, so moving text between two strings changes the hash */
+	return (hash ^ 0xffull) * 1099511628211ull;
+}
+
+static std::string GetString(unsigned int name)
+{
+	const char* value = (const char*)glGetString(name);
+	return value ? value : "";
+}
+
+static void MakeDirectory(const std::string& path)
+{
+#ifdef _MSC_VER
+	_mkdir(path.c_str());
+#else
+	mkdir(path.c_str(), 0755);
+#endif
+}
+
+ProgramCache& ProgramCache::Get()
+{
+	static ProgramCache s_Cache;
+	return s_Cache;
+}
+
+void ProgramCache::SetDirectory(const std::string& directory)
+{
+	m_Directory = directory;
+}
+
+bool ProgramCache::IsSupported()
+{
+	if (!m_Queried)
+	{
+		m_Queried = true;
+		m_DriverString = GetString(GL_VENDOR) + '\n' + GetString(GL_RENDERER) + '\n' + GetString(GL_VERSION);
+		m_DriverHash = HashString(s_FnvOffsetBasis, m_DriverString);
+
+		int formatCount = 0;
+		if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)
+		{
+			GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount));
+		}
+		m_Supported = formatCount > 0;
+	}
+	return m_Supported && !m_Directory.empty();
+}
+
+unsigned long long ProgramCache::GetKey(const std::string& vertexSource, const std::string& fragmentSource)
+{
+	IsSupported();
+
+	unsigned long long hash = s_FnvOffsetBasis;
+	hash = HashString(hash, m_DriverString);
+	hash = HashString(hash, vertexSource);
+	hash = HashString(hash, fragmentSource);
+	return hash;
+}
+
+unsigned int ProgramCache::Load(unsigned long long key)
+{
+	if (!IsSupported())
+		return 0;
+
+	std::ifstream stream(GetPath(key), std::ios::binary);
+	ProgramBinaryHeader header;
+	if (!stream.read((char*)&header, sizeof(header)))
+	{
+		m_Stats.Misses++;
+		return 0;
+	}
+
+	std::vector<char> binary;
+	bool valid = std::string(header.Magic, 4) == "GLPB" && header.Version == s_HeaderVersion;
+	if (valid && (header.Key != key || header.DriverHash != m_DriverHash))
+	{
+		/* Another program's binary, left for its owner; storing this one replaces it */
+		m_Stats.Misses++;
+		return 0;
+	}
+
+	if (valid)
+	{
+		/* A corrupt length must not size the allocation, the binary has to fit in what is left of the file */
+		std::streamoff start = stream.tellg();
+		stream.seekg(0, std::ios::end);
+		std::streamoff remaining = stream.tellg() - start;
+		stream.seekg(start);
+		valid = header.Length > 0 && (std::streamoff)header.Length <= remaining;
+	}
+
+	if (valid)
+	{
+		binary.resize(header.Length);
+		valid = (bool)stream.read(binary.data(), header.Length);
+	}
+	stream.close();
+
+	int linked = GL_FALSE;
+	unsigned int program = 0;
+	if (valid)
+	{
+		program = glCreateProgram();
+		/* A rejected binary is an expected outcome, not an error for GLCall to report */
+		glProgramBinary(program, header.Format, binary.data(), (int)header.Length);
+		glGetProgramiv(program, GL_LINK_STATUS, &linked);
+		GLClearError();
+	}
+
+	if (linked == GL_FALSE)
+	{
+		if (program)
+		{
+			GLCall(glDeleteProgram(program));
+		}
+		Remove(key);
+		m_Stats.Rejected++;
+		return 0;
+	}
+
+	m_Stats.Hits++;
+	m_Stats.BytesLoaded += header.Length;
+	return program;
+}
+
+void ProgramCache::Store(unsigned long long key, unsigned int program)
+{
+	if (!IsSupported())
+		return;
+
+	int linked = GL_FALSE;
+	int length = 0;
+	GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+	GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+	if (linked == GL_FALSE || length <= 0)
+		return;
+
+	ProgramBinaryHeader header = { { 'G', 'L', 'P', 'B' }, s_HeaderVersion, 0, 0, key, m_DriverHash };
+	std::vector<char> binary(length);
+	GLCall(glGetProgramBinary(program, length, &length, &header.Format, binary.data()));
+	header.Length = (unsigned int)length;
+
+	MakeDirectory(m_Directory);
+
+	/* Written next to the target and renamed, so a crash never leaves a truncated binary behind */
+	std::string path = GetPath(key);
+	std::string temporaryPath = path + ".tmp";
+	{
+		std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+		stream.write((const char*)&header, sizeof(header));
+		stream.write(binary.data(), header.Length);
+		if (!stream)
+		{
+			std::cout << "Warning: failed to write program binary '" << temporaryPath << "'" << std::endl;
+			return;
+		}
+	}
+
+	std::remove(path.c_str());
+	if (std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+	{
+		std::remove(temporaryPath.c_str());
+		return;
+	}
+
+	m_Stats.Stored++;
+	m_Stats.BytesStored += header.Length;
+}
+
+void ProgramCache::Remove(unsigned long long key)
+{
+	std::remove(GetPath(key).c_str());
+}
+
+std::string ProgramCache::GetPath(unsigned long long key) const
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.bin", key);
+	return m_Directory + '/' + name;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+
+/*
+ * Keeps linked programs on disk as glGetProgramBinary blobs, one file per
+ * program named after a 64 bit FNV-1a hash of the preprocessed stage sources
+ * (defines already injected) and the GL_VENDOR, GL_RENDERER and GL_VERSION
+ * strings, so a driver update or another GPU never sees a foreign binary.
+ * The file header repeats the key and a hash of the driver strings, a file
+ * that does not match both is a miss.
+ *
+ * A driver may still reject a binary it produced itself, e.g. after a driver
+ * side cache format change; Load then deletes the file and returns 0 and the
+ * caller compiles from source and stores the result again.
+ */
+class ProgramCache
+{
+public:
+	struct Stats
+	{
+		unsigned int Hits = 0;
+		unsigned int Misses = 0;
+		/* Binaries found on disk that glProgramBinary refused to link */
+		unsigned int Rejected = 0;
+		unsigned int Stored = 0;
+		size_t BytesLoaded = 0;
+		size_t BytesStored = 0;
+	};
+
+	static ProgramCache& Get();
+
+	/* Defaults to "shadercache", created on first store; an empty path disables the cache */
+	void SetDirectory(const std::string& directory);
+	inline const std::string& GetDirectory() const { return m_Directory; }
+
+	/* False without ARB_get_program_binary or when the driver exposes no binary format */
+	bool IsSupported();
+
+	unsigned long long GetKey(const std::string& vertexSource, const std::string& fragmentSource);
+
+	/* Returns a linked program, or 0 when there is no usable binary for key */
+	unsigned int Load(unsigned long long key);
+	/* program must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set */
+	void Store(unsigned long long key, unsigned int program);
+	void Remove(unsigned long long key);
+
+	inline const Stats& GetStats() const { return m_Stats; }
+	inline void ResetStats() { m_Stats = Stats(); }
+private:
+	ProgramCache() = default;
+
+	std::string GetPath(unsigned long long key) const;
+private:
+	std::string m_Directory = "shadercache";
+	/* Queried once the first time a context is current */
+	bool m_Queried = false;
+	bool m_Supported = false;
+	std::string m_DriverString;
+	unsigned long long m_DriverHash = 0;
+	Stats m_Stats;
+};
\ No newline at end of file
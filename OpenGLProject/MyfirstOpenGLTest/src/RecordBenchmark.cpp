@@ -0,0 +1,77 @@
+#include "RecordBenchmark.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "CommandBuffer.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+static double NowMs()
+{
+	using namespace std::chrono;
+	return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+void RunRecordBenchmark(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader, const Texture& texture,
+	unsigned int packetCount /*= 1 << 20*/)
+{
+	unsigned int maxThreads = std::thread::hardware_concurrency();
+	if (maxThreads == 0)
+		maxThreads = 1;
+
+	glm::mat4 projection = glm::ortho(-4.0f, 4.0f, -3.0f, 3.0f, -1.0f, 1.0f);
+	RenderQueue queue;
+	double baseline = 0.0;
+
+	std::cout << "threads\trecord ms\tmerge ms\tMpackets/s\tspeedup" << std::endl;
+
+	for (unsigned int threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+	{
+		std::vector<CommandBuffer> buffers(threadCount);
+		std::vector<std::thread> workers;
+		unsigned int perThread = packetCount / threadCount;
+
+		/* Warm the buffers up so growth is not part of the measurement */
+		for (auto& buffer : buffers)
+		{
+			for (unsigned int i = 0; i < perThread; i++)
+				buffer.Submit(vertexArray, indexBuffer, shader, &texture, projection, 0.0f, false);
+			buffer.Reset();
+		}
+
+		double start = NowMs();
+		for (unsigned int t = 0; t < threadCount; t++)
+		{
+			workers.emplace_back([&, t]()
+			{
+				CommandBuffer& buffer = buffers[t];
+				for (unsigned int i = 0; i < perThread; i++)
+				{
+					/* Stand-in for the per-object work a real scene does while recording */
+					float x = (float)(i % 64) * 0.125f - 4.0f;
+					float y = (float)(i / 64 % 48) * 0.125f - 3.0f;
+					glm::mat4 mvp = glm::translate(projection, glm::vec3(x, y, 0.0f));
+					buffer.Submit(vertexArray, indexBuffer, shader, &texture, mvp, (float)i / perThread, (i & 7) == 0);
+				}
+			});
+		}
+		for (auto& worker : workers)
+			worker.join();
+		double recorded = NowMs();
+
+		for (const auto& buffer : buffers)
+			queue.Merge(buffer);
+		double merged = NowMs();
+		queue.Clear();
+
+		double recordMs = recorded - start;
+		if (threadCount == 1)
+			baseline = recordMs;
+
+		std::cout << threadCount << "\t" << recordMs << "\t" << merged - recorded << "\t"
+			<< (perThread * threadCount) / (recordMs * 1000.0) << "\t" << baseline / recordMs << std::endl;
+	}
+}
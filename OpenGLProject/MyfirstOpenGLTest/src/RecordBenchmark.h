@@ -0,0 +1,12 @@
+#pragma once
+
+#include "Renderer.h"
+#include "Texture.h"
+
+/*
+ * Records packetCount draw packets split across 1, 2, 4 ... hardware threads
+ * into per-thread CommandBuffers, merges them into a RenderQueue and prints
+ * recording throughput and speedup for each thread count. Nothing is drawn.
+ */
+void RunRecordBenchmark(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader, const Texture& texture,
+	unsigned int packetCount = 1 << 20);
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "RenderQueue.h"
+#include "CommandBuffer.h"
+
+#include <algorithm>
+
+/* Set once per draw, hashed at compile time */
+static constexpr UniformID s_MVPUniform = "u_MVP";
+
+uint64_t SortKey::Make(unsigned int layer, bool translucent, unsigned int shaderID, unsigned int materialID, float depth)
+{
+	uint64_t quantizedDepth = (uint64_t)(std::min(std::max(depth, 0.0f), 1.0f) * 0xffffff);
+	uint64_t shader = shaderID & 0xffff;
+	uint64_t material = materialID & 0x7fff;
+
+	uint64_t key = (uint64_t)(layer & 0xff) << 56;
+	if (translucent)
+	{
+		key |= 1ull << 55;
+		key |= (0xffffff - quantizedDepth) << 31;
+		key |= shader << 15;
+		key |= material;
+	}
+	else
+	{
+		key |= shader << 39;
+		key |= material << 24;
+		key |= quantizedDepth;
+	}
+
+	return key;
+}
+
+RenderCommand RenderCommand::Make(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader, const Texture* texture,
+	const glm::mat4& mvp, float depth, bool translucent, unsigned int layer)
+{
+	unsigned int materialID = texture ? texture->GetRendererID() : 0;
+	uint64_t key = SortKey::Make(layer, translucent, shader.GetRendererID(), materialID, depth);
+
+	return { key, &vertexArray, &indexBuffer, &shader, texture, mvp };
+}
+
+void RenderQueue::Submit(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader, const Texture* texture,
+	const glm::mat4& mvp, float depth, bool translucent, unsigned int layer /*= 0*/)
+{
+	m_Commands.push_back(RenderCommand::Make(vertexArray, indexBuffer, shader, texture, mvp, depth, translucent, layer));
+}
+
+void RenderQueue::Merge(const CommandBuffer& commandBuffer)
+{
+	m_Commands.insert(m_Commands.end(), commandBuffer.begin(), commandBuffer.end());
+}
+
+void RenderQueue::Clear()
+{
+	m_Commands.clear();
+}
+
+void RenderQueue::Flush(const Renderer& renderer)
+{
+	Sort();
+
+	const Shader* lastShader = nullptr;
+	const Texture* lastTexture = nullptr;
+	const VertexArray* lastVertexArray = nullptr;
+
+	for (uint32_t index : m_Order)
+	{
+		RenderCommand& command = m_Commands[index];
+
+		if (command.Program != lastShader)
+		{
+			m_Stats.ProgramChanges++;
+			lastShader = command.Program;
+		}
+		if (command.Material && command.Material != lastTexture)
+		{
+			command.Material->Bind();
+			m_Stats.TextureChanges++;
+			lastTexture = command.Material;
+		}
+		if (command.VertexArr != lastVertexArray)
+		{
+			m_Stats.VertexArrayChanges++;
+			lastVertexArray = command.VertexArr;
+		}
+
+		command.Program->Bind();
+		command.Program->SetUniformMat4f(s_MVPUniform, command.MVP);
+		renderer.Draw(*command.VertexArr, *command.Indices, *command.Program);
+		m_Stats.DrawCount++;
+	}
+
+	m_Commands.clear();
+}
+
+void RenderQueue::Sort()
+{
+	uint32_t count = (uint32_t)m_Commands.size();
+	m_Order.resize(count);
+	m_Scratch.resize(count);
+	for (uint32_t i = 0; i < count; i++)
+		m_Order[i] = i;
+
+	/* LSD radix sort over the 8 key bytes, stable so equal keys keep submission order */
+	for (unsigned int shift = 0; shift < 64; shift += 8)
+	{
+		uint32_t histogram[256] = {};
+		for (const auto& command : m_Commands)
+			histogram[(command.Key >> shift) & 0xff]++;
+
+		/* Every key has the same byte here, the pass would not move anything */
+		if (histogram[(m_Commands.empty() ? 0 : m_Commands[0].Key >> shift) & 0xff] == count)
+			continue;
+
+		uint32_t offset = 0;
+		for (unsigned int i = 0; i < 256; i++)
+		{
+			uint32_t bucket = histogram[i];
+			histogram[i] = offset;
+			offset += bucket;
+		}
+
+		for (uint32_t index : m_Order)
+			m_Scratch[histogram[(m_Commands[index].Key >> shift) & 0xff]++] = index;
+
+		m_Order.swap(m_Scratch);
+	}
+}
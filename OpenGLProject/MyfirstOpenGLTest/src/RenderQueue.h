@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Renderer.h"
+#include "Texture.h"
+
+#include "glm/glm.hpp"
+
+/*
+ * 64-bit draw sort key, most significant field first:
+ *
+ *   opaque      | layer:8 | 0 | shader:16 | material:15 | depth:24        |
+ *   translucent | layer:8 | 1 | ~depth:24        | shader:16 | material:15 |
+ *
+ * Opaque draws are grouped by state and then go front to back, translucent
+ * draws are drawn after them back to front so blending stays correct.
+ */
+namespace SortKey
+{
+	uint64_t Make(unsigned int layer, bool translucent, unsigned int shaderID, unsigned int materialID, float depth);
+}
+
+struct RenderCommand
+{
+	uint64_t Key;
+	const VertexArray* VertexArr;
+	IndexBuffer* Indices;
+	Shader* Program;
+	const Texture* Material;
+	glm::mat4 MVP;
+
+	static RenderCommand Make(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader, const Texture* texture,
+		const glm::mat4& mvp, float depth, bool translucent, unsigned int layer);
+};
+
+class CommandBuffer;
+
+/*
+ * Deferred replacement for calling Renderer::Draw directly. Draws are
+ * submitted during the frame, radix sorted by key and executed by Flush().
+ */
+class RenderQueue
+{
+public:
+	struct Stats
+	{
+		unsigned int DrawCount = 0;
+		unsigned int ProgramChanges = 0;
+		unsigned int TextureChanges = 0;
+		unsigned int VertexArrayChanges = 0;
+	};
+
+	/* depth is the normalized view depth, 0 at the near plane and 1 at the far plane */
+	void Submit(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader, const Texture* texture,
+		const glm::mat4& mvp, float depth, bool translucent, unsigned int layer = 0);
+
+	/* Appends the packets a worker recorded, call on the submitting thread once the worker is done */
+	void Merge(const CommandBuffer& commandBuffer);
+
+	void Flush(const Renderer& renderer);
+	/* Drops everything submitted so far without drawing it */
+	void Clear();
+
+	inline unsigned int GetCount() const { return (unsigned int)m_Commands.size(); }
+
+	inline const Stats& GetStats() const { return m_Stats; }
+	inline void ResetStats() { m_Stats = Stats(); }
+private:
+	void Sort();
+private:
+	std::vector<RenderCommand> m_Commands;
+	/* Scratch storage for the radix sort, kept to avoid reallocating every frame */
+	std::vector<uint32_t> m_Order;
+	std::vector<uint32_t> m_Scratch;
+
+	Stats m_Stats;
+};
@@ -0,0 +1,125 @@
+#include "RenderThread.h"
+#include "Profiler.h"
+
+#include <chrono>
+
+#include <GLFW/glfw3.h>
+
+static double NowMs()
+{
+	using namespace std::chrono;
+	return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+RenderThread::RenderThread(GLFWwindow* window, const Renderer& renderer)
+	: m_Window(window), m_Renderer(renderer), m_RecordIndex(0), m_FramePending(false), m_Running(false), m_LastSubmit(0.0)
+{
+}
+
+RenderThread::~RenderThread()
+{
+	Stop();
+}
+
+void RenderThread::Start()
+{
+	if (m_Running)
+		return;
+
+	/* A context can only be current on one thread, hand it to the render thread */
+	glfwMakeContextCurrent(nullptr);
+
+	m_Running = true;
+	m_LastSubmit = NowMs();
+	m_Thread = std::thread(&RenderThread::Run, this);
+}
+
+void RenderThread::Stop()
+{
+	if (!m_Running)
+		return;
+
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Condition.wait(lock, [this] { return !m_FramePending; });
+		m_Running = false;
+	}
+	m_Condition.notify_all();
+	m_Thread.join();
+
+	glfwMakeContextCurrent(m_Window);
+	/* The render thread changed bindings behind this thread's cache */
+	GLState::Get().Invalidate();
+}
+
+void RenderThread::SubmitFrame()
+{
+	double start = NowMs();
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Condition.wait(lock, [this] { return !m_FramePending; });
+
+		m_FramePending = true;
+		m_RecordIndex ^= 1;
+
+		double end = NowMs();
+		m_Timings.FrameCount++;
+		m_Timings.RecordMs += start - m_LastSubmit;
+		m_Timings.SubmitWaitMs += end - start;
+		m_LastSubmit = end;
+	}
+	m_Condition.notify_all();
+
+	m_Lists[m_RecordIndex].Reset();
+}
+
+RenderThread::Timings RenderThread::GetTimings()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Timings;
+}
+
+void RenderThread::Run()
+{
+	glfwMakeContextCurrent(m_Window);
+	GLState::Get().Invalidate();
+
+	while (true)
+	{
+		double idleStart = NowMs();
+		unsigned int executeIndex;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [this] { return m_FramePending || !m_Running; });
+			if (!m_FramePending)
+				break;
+
+			/* The main thread flipped the index when it submitted, the other list is ours */
+			executeIndex = m_RecordIndex ^ 1;
+		}
+
+		double executeStart = NowMs();
+		{
+			PROFILE_SCOPE("RenderThread::Execute");
+			m_Lists[executeIndex].Execute(m_Renderer);
+		}
+
+		double swapStart = NowMs();
+		{
+			PROFILE_SCOPE("RenderThread::SwapBuffers");
+			glfwSwapBuffers(m_Window);
+		}
+		double swapEnd = NowMs();
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_FramePending = false;
+			m_Timings.IdleMs += executeStart - idleStart;
+			m_Timings.ExecuteMs += swapStart - executeStart;
+			m_Timings.SwapMs += swapEnd - swapStart;
+		}
+		m_Condition.notify_all();
+	}
+
+	glfwMakeContextCurrent(nullptr);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "CommandList.h"
+
+struct GLFWwindow;
+
+/*
+ * Owns the window's GL context on a dedicated thread and replays the command
+ * list the main thread submitted for the previous frame. There are two lists:
+ * the main thread records into one while the render thread executes the
+ * other, so the render thread is never more than one frame behind.
+ *
+ * GL resources are created before Start() and destroyed after Stop(), while
+ * the context is current on the main thread.
+ */
+class RenderThread
+{
+public:
+	/* Accumulated milliseconds, divide by FrameCount for per frame values */
+	struct Timings
+	{
+		unsigned int FrameCount = 0;
+		/* Main thread: time spent between submits, and time blocked in SubmitFrame */
+		double RecordMs = 0.0;
+		double SubmitWaitMs = 0.0;
+		/* Render thread: replaying commands, swapping, and waiting for work */
+		double ExecuteMs = 0.0;
+		double SwapMs = 0.0;
+		double IdleMs = 0.0;
+	};
+
+	RenderThread(GLFWwindow* window, const Renderer& renderer);
+	~RenderThread();
+
+	void Start();
+	void Stop();
+
+	/* The list the main thread records the next frame into */
+	inline CommandList& GetRecordList() { return m_Lists[m_RecordIndex]; }
+	/* Hands the recorded list over, waiting if the previous frame is still being executed */
+	void SubmitFrame();
+
+	Timings GetTimings();
+private:
+	void Run();
+private:
+	GLFWwindow* m_Window;
+	const Renderer& m_Renderer;
+
+	CommandList m_Lists[2];
+	unsigned int m_RecordIndex;
+
+	std::thread m_Thread;
+	std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+	bool m_FramePending;
+	bool m_Running;
+
+	double m_LastSubmit;
+	Timings m_Timings;
+};
\ No newline at end of file
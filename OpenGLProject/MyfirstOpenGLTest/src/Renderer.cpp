@@ -2,6 +2,11 @@
 
 #include <iostream>
 
+#include "Profiler.h"
+#include "GeometryPool.h"
+#include "LodChain.h"
+#include "VertexArrayCache.h"
+
 void GLClearError()
 {
     while (glGetError() != GL_NO_ERROR);
@@ -12,7 +17,7 @@ bool GLLogCall(const char* function, const char* file, int line)
     while (GLenum error = glGetError())
     {
         std::cout << "[OpenGL_Error] (" << error << ") : " << function <<
-            "\n" << file << ":" << file << "\t" << "Line : " << line << std::endl;
+            "\n" << file << ":" << line << "\n";
         return false;
     }
 
@@ -26,9 +31,103 @@ void Renderer::Clear() const
 
 void Renderer::Draw(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader) const
 {
+    PROFILE_SCOPE("Renderer::Draw");
+
+    BufferShadow::FlushPending();
+
 	/* Draw the triangle */
 	shader.Bind();
+	shader.FlushUniforms();
 	vertexArray.Bind();
 	indexBuffer.Bind();
-    GLCall(glDrawElements(GL_TRIANGLES, indexBuffer.GetCount(), GL_UNSIGNED_INT, nullptr));
+    GLCall(glDrawElements(GL_TRIANGLES, indexBuffer.GetCount(), indexBuffer.GetType(), nullptr));
+}
+
+void Renderer::Draw(const VertexBuffer& vertexBuffer, const VertexBufferLayout& layout, IndexBuffer& indexBuffer, Shader& shader) const
+{
+    BufferShadow::FlushPending();
+
+    shader.Bind();
+    shader.FlushUniforms();
+    VertexArrayCache::Get().Bind(vertexBuffer, layout, indexBuffer);
+    GLCall(glDrawElements(GL_TRIANGLES, indexBuffer.GetCount(), indexBuffer.GetType(), nullptr));
+}
+
+void Renderer::Draw(const GeometryPool& pool, unsigned int mesh, Shader& shader) const
+{
+    BufferShadow::FlushPending();
+
+    const GeometryPool::Mesh& record = pool.GetMesh(mesh);
+    const IndexBuffer& indexBuffer = pool.GetIndexBuffer(record.Page);
+    shader.Bind();
+    shader.FlushUniforms();
+    pool.GetVertexArray(record.Page).Bind();
+    indexBuffer.Bind();
+
+    void* offset = (void*)(uintptr_t)(record.FirstIndex * indexBuffer.GetIndexSize());
+    GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, record.IndexCount, indexBuffer.GetType(), offset, record.BaseVertex));
+}
+
+void Renderer::Draw(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader, const LodChain& lods, unsigned int level) const
+{
+    BufferShadow::FlushPending();
+
+    const LodChain::Level& range = lods.GetLevel(level);
+    shader.Bind();
+    shader.FlushUniforms();
+    vertexArray.Bind();
+    indexBuffer.Bind();
+
+    const void* offset = (const void*)(uintptr_t)(range.FirstIndex * indexBuffer.GetIndexSize());
+    GLCall(glDrawElements(GL_TRIANGLES, range.IndexCount, indexBuffer.GetType(), offset));
+}
+
+void Renderer::DrawInstanced(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader,
+    unsigned int instanceCount, unsigned int baseInstance /*= 0*/) const
+{
+    BufferShadow::FlushPending();
+
+    shader.Bind();
+    shader.FlushUniforms();
+    vertexArray.Bind();
+    indexBuffer.Bind();
+
+    if (baseInstance == 0)
+    {
+        GLCall(glDrawElementsInstanced(GL_TRIANGLES, indexBuffer.GetCount(), indexBuffer.GetType(), nullptr, instanceCount));
+        return;
+    }
+
+    ASSERT(GLEW_VERSION_4_2 || GLEW_ARB_base_instance);
+    GLCall(glDrawElementsInstancedBaseInstance(GL_TRIANGLES, indexBuffer.GetCount(), indexBuffer.GetType(), nullptr, instanceCount, baseInstance));
+}
+
+void Renderer::MultiDrawIndirect(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader, IndirectBuffer& indirectBuffer) const
+{
+    if (indirectBuffer.GetCount() == 0)
+        return;
+
+    BufferShadow::FlushPending();
+
+    shader.Bind();
+    shader.FlushUniforms();
+    vertexArray.Bind();
+    indexBuffer.Bind();
+
+    if (GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect)
+    {
+        indirectBuffer.Upload();
+        indirectBuffer.Bind();
+        GLCall(glMultiDrawElementsIndirect(GL_TRIANGLES, indexBuffer.GetType(), nullptr, indirectBuffer.GetCount(), 0));
+        return;
+    }
+
+    /* Without multi-draw, replay the same commands one by one so BaseInstance still reaches the shader */
+    ASSERT(GLEW_VERSION_4_2 || GLEW_ARB_base_instance);
+    for (const auto& command : indirectBuffer.GetCommands())
+    {
+        const void* offset = (const void*)(uintptr_t)(command.FirstIndex * indexBuffer.GetIndexSize());
+        GLCall(glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, command.Count, indexBuffer.GetType(), offset,
+            command.InstanceCount, command.BaseVertex, command.BaseInstance));
+    }
 }
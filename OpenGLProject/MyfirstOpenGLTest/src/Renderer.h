@@ -5,18 +5,113 @@
 #include "VertexArray.h"
 #include "IndexBuffer.h"
 #include "Shader.h"
+#include "IndirectBuffer.h"
+#include "GLState.h"
 
-#define ASSERT(x) if (!(x)) __debugbreak();
-#define GLCall(x) GLClearError();\
+#ifdef _MSC_VER
+#define DEBUG_BREAK() __debugbreak()
+#else
+#define DEBUG_BREAK() __builtin_trap()
+#endif
+
+#define ASSERT(x) if (!(x)) DEBUG_BREAK();
+
+/*
+ * How GLCall checks glGetError. Errors are reported through KHR_debug (see
+ * GLDebug.h) in every mode; glGetError is only the fallback for contexts
+ * without debug output, and each check is a driver round trip that
+ * serializes threaded drivers.
+ *
+ *   GL_ERROR_CHECK_OFF      GLCall(x) is just x
+ *   GL_ERROR_CHECK_SAMPLED  glGetError after every GL_ERROR_SAMPLE_PERIOD-th call,
+ *                           the error may come from any call since the last check
+ *   GL_ERROR_CHECK_ALL      clear before and check after every call
+ *
+ * Define GL_COUNT_CALLS to have GLCall also count the calls made on each
+ * thread for GLCallCount, as the headless benchmark build does. Without it the
+ * count is only kept by the sampled mode, which needs it to pick the calls to
+ * check, and GL_ERROR_CHECK_OFF stays a bare x.
+ */
+#define GL_ERROR_CHECK_OFF 0
+#define GL_ERROR_CHECK_SAMPLED 1
+#define GL_ERROR_CHECK_ALL 2
+
+#ifndef GL_ERROR_CHECK
+#ifdef _DEBUG
+#define GL_ERROR_CHECK GL_ERROR_CHECK_SAMPLED
+#else
+#define GL_ERROR_CHECK GL_ERROR_CHECK_OFF
+#endif
+#endif
+
+#ifndef GL_ERROR_SAMPLE_PERIOD
+#define GL_ERROR_SAMPLE_PERIOD 64
+#endif
+
+#ifdef GL_COUNT_CALLS
+#define GL_COUNT_CALL() GLCountCall();
+#else
+#define GL_COUNT_CALL()
+#endif
+
+/* Every mode is one statement, so GLCall(x); is safe under an unbraced if */
+#if GL_ERROR_CHECK == GL_ERROR_CHECK_ALL
+#define GLCall(x) do {\
+    GL_COUNT_CALL()\
+    GLClearError();\
+    x;\
+    ASSERT(GLLogCall(#x, __FILE__, __LINE__))\
+    } while (0)
+#elif GL_ERROR_CHECK == GL_ERROR_CHECK_SAMPLED
+#define GLCall(x) do {\
+    GLCountCall();\
     x;\
-    ASSERT(GLLogCall(#x, __FILE__, __LINE__))
+    if (GLShouldSampleError()) { ASSERT(GLLogCall(#x, __FILE__, __LINE__)) }\
+    } while (0)
+#else
+#define GLCall(x) do { GL_COUNT_CALL() x; } while (0)
+#endif
 
 void GLClearError();
 bool GLLogCall(const char* function, const char* file, int line);
 
+/* Calls made through GLCall on this thread, compare it before and after a piece of code to count its API calls */
+inline unsigned long long& GLCallCount()
+{
+    static thread_local unsigned long long s_Calls = 0;
+    return s_Calls;
+}
+
+inline void GLCountCall()
+{
+    ++GLCallCount();
+}
+
+/* The sampled GLCall counts the call first, this picks every GL_ERROR_SAMPLE_PERIOD-th one */
+inline bool GLShouldSampleError()
+{
+    return GLCallCount() % GL_ERROR_SAMPLE_PERIOD == 0;
+}
+
+class GeometryPool;
+class LodChain;
+class VertexBufferLayout;
+
+/* Every draw first uploads the pending VertexBuffer/IndexBuffer::Update writes */
 class Renderer
 {
 public:
     void Clear() const;
     void Draw(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader) const;
+    /* For meshes without their own VertexArray, the VAO comes from VertexArrayCache */
+    void Draw(const VertexBuffer& vertexBuffer, const VertexBufferLayout& layout, IndexBuffer& indexBuffer, Shader& shader) const;
+    /* Draws one pooled mesh; consecutive meshes of the same page reuse its VAO binding */
+    void Draw(const GeometryPool& pool, unsigned int mesh, Shader& shader) const;
+    /* Draws one level of a LodChain whose levels share indexBuffer, see LodChain::Select */
+    void Draw(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader, const LodChain& lods, unsigned int level) const;
+    /* Draws instanceCount copies, baseInstance offsets the per-instance attributes (GL 4.2 / ARB_base_instance) */
+    void DrawInstanced(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader,
+        unsigned int instanceCount, unsigned int baseInstance = 0) const;
+    /* Submits every command in the indirect buffer with one glMultiDrawElementsIndirect (GL 4.3) */
+    void MultiDrawIndirect(const VertexArray& vertexArray, IndexBuffer& indexBuffer, Shader& shader, IndirectBuffer& indirectBuffer) const;
 };
\ No newline at end of file
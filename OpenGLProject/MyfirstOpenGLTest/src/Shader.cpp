@@ -5,13 +5,47 @@
 #include <string>
 #include <sstream>
 
+#ifdef _MSC_VER
+#include <malloc.h>
+#else
+#include <alloca.h>
+#endif
+
 #include "Renderer.h"
+#include "Profiler.h"
+#include "GLDebug.h"
+#include "ProgramCache.h"
 
-Shader::Shader(const std::string& filepath)
-	:m_FilePath(filepath), m_RendererID(0)
+Shader::Shader(const std::string& filepath, const std::vector<std::string>& defines /*= {}*/)
+	:m_RendererID(0), m_FilePath(filepath)
 {
-	ShaderProgramSource shaderProgram = ParseShader();
-	m_RendererID = CreateShader(shaderProgram.VertexSource, shaderProgram.FragmentSource);
+	PROFILE_SCOPE("Shader::Shader");
+
+	ShaderProgramSource shaderProgram = LoadSource(filepath, defines);
+
+	/* Compiling from source is the fallback for a cold cache or a binary the driver rejects */
+	ProgramCache& programCache = ProgramCache::Get();
+	m_ProgramKey = programCache.GetKey(shaderProgram.VertexSource, shaderProgram.FragmentSource);
+	m_RendererID = programCache.Load(m_ProgramKey);
+	if (m_RendererID == 0)
+	{
+		m_RendererID = CreateShader(shaderProgram.VertexSource, shaderProgram.FragmentSource);
+
+		/* The build failure has been printed, a program of 0 binds nothing and draws nothing */
+		if (m_RendererID == 0)
+			return;
+
+		programCache.Store(m_ProgramKey, m_RendererID);
+	}
+	GLDebug::Get().Label(GL_PROGRAM, m_RendererID, m_FilePath);
+	m_Uniforms.Reflect(m_RendererID, m_FilePath, shaderProgram.VertexSource, shaderProgram.FragmentSource);
+}
+
+Shader::Shader(const std::string& filepath, unsigned int program, unsigned long long programKey, const ShaderProgramSource& source)
+	:m_RendererID(program), m_FilePath(filepath), m_ProgramKey(programKey)
+{
+	GLDebug::Get().Label(GL_PROGRAM, m_RendererID, m_FilePath);
+	m_Uniforms.Reflect(m_RendererID, m_FilePath, source.VertexSource, source.FragmentSource);
 }
 
 Shader::~Shader()
@@ -21,37 +55,56 @@ Shader::~Shader()
 
 void Shader::Bind() const
 {
-	GLCall(glUseProgram(m_RendererID));
+	GLState::Get().UseProgram(m_RendererID);
 }
 
 void Shader::UnBind() const
 {
-	GLCall(glUseProgram(0));
+	GLState::Get().UseProgram(0);
+}
+
+void Shader::FlushUniforms()
+{
+	m_Uniforms.Flush();
+}
+
+void Shader::SetUniform1i(UniformHandle uniform, int value)
+{
+	m_Uniforms.Set(uniform, UniformValueType::Int, 1, &value);
+}
+
+void Shader::SetUniform1iv(UniformHandle uniform, int count, const int* values)
+{
+	m_Uniforms.Set(uniform, UniformValueType::Int, count, values);
 }
 
-void Shader::SetUniform1i(const std::string& name, int value)
+void Shader::SetUniform1f(UniformHandle uniform, float value)
 {
-	GLCall(glUniform1i(GetUnifromLoacation(name), value));
+	m_Uniforms.Set(uniform, UniformValueType::Float, 1, &value);
 }
 
-void Shader::SetUniform1f(const std::string& name, float value)
+void Shader::SetUniform4f(UniformHandle uniform, float v0, float v1, float v2, float v3)
 {
-	GLCall(glUniform1f(GetUnifromLoacation(name), value));
+	const float values[] = { v0, v1, v2, v3 };
+	m_Uniforms.Set(uniform, UniformValueType::Float4, 1, values);
 }
 
-void Shader::SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3)
+void Shader::SetUniformMat4f(UniformHandle uniform, const glm::mat4& matrix)
 {
-	GLCall(glUniform4f(GetUnifromLoacation(name), v0, v1, v2, v3));
+	m_Uniforms.Set(uniform, UniformValueType::Mat4, 1, &matrix[0][0]);
 }
 
-void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
+ShaderProgramSource Shader::LoadSource(const std::string& filepath, const std::vector<std::string>& defines /*= {}*/)
 {
-	GLCall(glUniformMatrix4fv(GetUnifromLoacation(name), 1, GL_FALSE, &matrix[0][0]));
+	ShaderProgramSource source = ParseShader(filepath);
+	source.VertexSource = InsertDefines(source.VertexSource, defines);
+	source.FragmentSource = InsertDefines(source.FragmentSource, defines);
+	return source;
 }
 
-ShaderProgramSource Shader::ParseShader()
+ShaderProgramSource Shader::ParseShader(const std::string& filepath)
 {
-	std::ifstream stream(m_FilePath);
+	std::ifstream stream(filepath);
 
 	enum class ShaderType {
 		NODE = -1, VERTEX = 0, FRAGMENT = 1
@@ -83,8 +136,31 @@ ShaderProgramSource Shader::ParseShader()
 	return { ss[0].str(), ss[1].str() };
 }
 
+std::string Shader::InsertDefines(const std::string& source, const std::vector<std::string>& defines)
+{
+	if (defines.empty())
+		return source;
+
+	std::string lines;
+	for (const std::string& define : defines)
+		lines += "#define " + define + '\n';
+
+	/* GLSL only allows comments and blank lines before #version */
+	size_t version = source.find("#version");
+	if (version == std::string::npos)
+		return lines + source;
+
+	size_t lineEnd = source.find('\n', version);
+	if (lineEnd == std::string::npos)
+		return source + '\n' + lines;
+
+	return source.substr(0, lineEnd + 1) + lines + source.substr(lineEnd + 1);
+}
+
 unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 {
+	PROFILE_SCOPE("Shader::CompileShader");
+
 	/* Creates a shader object */
 	unsigned int id = glCreateShader(type);
 
@@ -97,7 +173,6 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 	/* Compiles a shader object */
 	glCompileShader(id);
 
-	// TODO: Error handling
 	int result;
 	glGetShaderiv(id, GL_COMPILE_STATUS, &result);
 	if (result == GL_FALSE)
@@ -126,11 +201,29 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 
 unsigned int Shader::CreateShader(const std::string& vertexShader, const std::string& fragmentShader)
 {
+	PROFILE_SCOPE("Shader::CreateShader");
+
 	unsigned int program = glCreateProgram();
 
+	/* Lets ProgramCache read the linked binary back */
+	if (ProgramCache::Get().IsSupported())
+	{
+		GLCall(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+	}
+
 	unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
 	unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
 
+	/* CompileShader has printed why, a program missing a stage cannot link */
+	if (vs == 0 || fs == 0)
+	{
+		glDeleteShader(vs);
+		glDeleteShader(fs);
+		glDeleteProgram(program);
+
+		return 0;
+	}
+
 	/* Attaches a shader object to a program object */
 	GLCall(glAttachShader(program, vs));
 	GLCall(glAttachShader(program, fs));
@@ -138,29 +231,36 @@ unsigned int Shader::CreateShader(const std::string& vertexShader, const std::st
 	/* Links a program object */
 	GLCall(glLinkProgram(program));
 
-	/* Validates a program object */
-	GLCall(glValidateProgram(program));
-
 	GLCall(glDeleteShader(vs));
 	GLCall(glDeleteShader(fs));
 
-	return program;
+	int result;
+	glGetProgramiv(program, GL_LINK_STATUS, &result);
+	if (result == GL_FALSE)
+	{
+		int length;
 
-}
+		/* Returns a parameter from a program object */
+		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
 
-int Shader::GetUnifromLoacation(const std::string& name)
-{
-	if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
-	{
-		return m_UniformLocationCache[name];
-	}
+		char* message = (char*)alloca((length + 1) * sizeof(char));
+		message[0] = '\0';
 
-	GLCall(int location = glGetUniformLocation(m_RendererID, name.c_str()));
-	if (location == -1)
-	{
-		std::cout << "Warning: uniform '" << name << "' doesn't exist!" << std::endl;
+		/* Returns the information log for a program object */
+		glGetProgramInfoLog(program, length + 1, &length, message);
+
+		std::cout << "Failed to link program !" << std::endl;
+
+		std::cout << message << std::endl;
+
+		glDeleteProgram(program);
+
+		return 0;
 	}
 
-	m_UniformLocationCache[name] = location;
-	return location;
+	/* Validates a program object */
+	GLCall(glValidateProgram(program));
+
+	return program;
+
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <string>
-#include <unordered_map>
+#include <vector>
+
+#include "UniformTable.h"
 
 #include "glm/glm.hpp"
 
@@ -16,23 +18,50 @@ class Shader
 private:
 	unsigned int m_RendererID;
 	std::string m_FilePath;
-	std::unordered_map<std::string, int> m_UniformLocationCache;
+	/* ProgramCache key of the preprocessed sources */
+	unsigned long long m_ProgramKey;
+	UniformTable m_Uniforms;
 	
 public:
-	Shader(const std::string& filepath);
+	/* Each define is "NAME" or "NAME VALUE" and is inserted after the #version line of both stages */
+	Shader(const std::string& filepath, const std::vector<std::string>& defines = {});
+	/* Takes ownership of a program linked elsewhere from source, e.g. by ShaderCompiler */
+	Shader(const std::string& filepath, unsigned int program, unsigned long long programKey, const ShaderProgramSource& source);
 	~Shader();
 
 	void Bind() const;
 	void UnBind() const;
 
-	// Set uniforms
-	void SetUniform1i(const std::string& name, int value);
-	void SetUniform1f(const std::string& name, float value);
-	void SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3);
-	void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+	inline unsigned long long GetProgramKey() const { return m_ProgramKey; }
+	inline const UniformTable& GetUniforms() const { return m_Uniforms; }
+
+	/* Resolve a name once for a uniform set every draw, the handle overloads below skip the lookup */
+	inline UniformHandle GetUniformHandle(UniformID name) { return m_Uniforms.GetHandle(name); }
+
+	// Set uniforms, uploaded by FlushUniforms and only when the value changed
+	void SetUniform1i(UniformHandle uniform, int value);
+	void SetUniform1iv(UniformHandle uniform, int count, const int* values);
+	void SetUniform1f(UniformHandle uniform, float value);
+	void SetUniform4f(UniformHandle uniform, float v0, float v1, float v2, float v3);
+	void SetUniformMat4f(UniformHandle uniform, const glm::mat4& matrix);
+
+	inline void SetUniform1i(UniformID name, int value) { SetUniform1i(GetUniformHandle(name), value); }
+	inline void SetUniform1iv(UniformID name, int count, const int* values) { SetUniform1iv(GetUniformHandle(name), count, values); }
+	inline void SetUniform1f(UniformID name, float value) { SetUniform1f(GetUniformHandle(name), value); }
+	inline void SetUniform4f(UniformID name, float v0, float v1, float v2, float v3) { SetUniform4f(GetUniformHandle(name), v0, v1, v2, v3); }
+	inline void SetUniformMat4f(UniformID name, const glm::mat4& matrix) { SetUniformMat4f(GetUniformHandle(name), matrix); }
+
+	/* Uploads the uniforms changed since the last flush; the renderer calls it after Bind before every draw */
+	void FlushUniforms();
+	/* After changing uniforms of this program with glUniform* directly */
+	inline void InvalidateUniforms() { m_Uniforms.Invalidate(); }
+
+	/* Both stages of a .shader file with the defines inserted, the source ProgramCache hashes */
+	static ShaderProgramSource LoadSource(const std::string& filepath, const std::vector<std::string>& defines = {});
 private:
-	ShaderProgramSource ParseShader();
+	static ShaderProgramSource ParseShader(const std::string& filepath);
+	static std::string InsertDefines(const std::string& source, const std::vector<std::string>& defines);
 	unsigned int CompileShader(unsigned int type, const std::string& source);
 	unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
-	int GetUnifromLoacation(const std::string& name);
 };
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "ShaderCacheBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Renderer.h"
+#include "ProgramCache.h"
+
+static double NowMs()
+{
+	using namespace std::chrono;
+	return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+void RunShaderCacheBenchmark(ShaderCompiler::ContextBinder workerContext /*= nullptr*/, unsigned int variantCount /*= 16*/)
+{
+	static const char* s_ShaderPaths[] = {
+		"res/shaders/Basic.shader",
+		"res/shaders/Batch.shader",
+		"res/shaders/Instanced.shader",
+		"res/shaders/Mesh.shader"
+	};
+
+	ProgramCache& programCache = ProgramCache::Get();
+	std::string directory = programCache.GetDirectory();
+	if (!programCache.IsSupported())
+		std::cout << "Program binaries are not supported by this driver, every pass compiles" << std::endl;
+
+	/* Unique per run, a binary left over from an earlier run would turn the cold pass warm */
+	long long run = std::chrono::steady_clock::now().time_since_epoch().count();
+	std::vector<unsigned long long> keys;
+
+	auto forEachPermutation = [&](const std::string& tag, const std::function<void(const char*, const std::vector<std::string>&)>& create)
+	{
+		for (unsigned int variant = 0; variant < variantCount; variant++)
+		{
+			for (const char* path : s_ShaderPaths)
+			{
+				create(path, {
+					"SHADER_CACHE_BENCH_RUN " + tag + std::to_string(run),
+					"SHADER_CACHE_BENCH_VARIANT " + std::to_string(variant)
+				});
+			}
+		}
+	};
+
+	auto pass = [&](const char* name, const std::string& tag, bool cached)
+	{
+		programCache.SetDirectory(cached ? directory : "");
+		programCache.ResetStats();
+
+		std::vector<std::unique_ptr<Shader>> shaders;
+		glFinish();
+		double start = NowMs();
+		forEachPermutation(tag, [&](const char* path, const std::vector<std::string>& defines)
+		{
+			shaders.push_back(std::make_unique<Shader>(path, defines));
+
+			/* Drivers may finish compiling lazily, the link status waits for it */
+			int linked;
+			GLCall(glGetProgramiv(shaders.back()->GetRendererID(), GL_LINK_STATUS, &linked));
+		});
+		double ms = NowMs() - start;
+
+		const ProgramCache::Stats& stats = programCache.GetStats();
+		std::cout << name << "\t" << shaders.size() << "\t" << ms << "\t" << ms / shaders.size()
+			<< "\t" << stats.Hits << "\t" << stats.Misses << "\t" << stats.Rejected
+			<< "\t" << (stats.BytesLoaded + stats.BytesStored) / 1024 << std::endl;
+
+		if (cached)
+		{
+			for (const std::unique_ptr<Shader>& shader : shaders)
+				keys.push_back(shader->GetProgramKey());
+		}
+	};
+
+	std::cout << "pass\tprograms\ttotal ms\tms/program\thits\tmisses\trejected\tKiB" << std::endl;
+	pass("no cache", "uncached", false);
+	pass("cold", "cached", true);
+	pass("warm", "cached", true);
+
+	for (unsigned long long key : keys)
+		programCache.Remove(key);
+
+	/* Compiles only, a cache hit never reaches the compiler */
+	programCache.SetDirectory("");
+
+	Shader fallback("res/shaders/Fallback.shader");
+	ShaderCompiler compiler(fallback, workerContext);
+
+	auto asyncPass = [&](const char* name, ShaderCompiler::Mode mode)
+	{
+		if (!compiler.SetMode(mode))
+			return;
+
+		std::vector<std::shared_ptr<ShaderHandle>> handles;
+		glFinish();
+		double start = NowMs();
+		forEachPermutation(name, [&](const char* path, const std::vector<std::string>& defines)
+		{
+			handles.push_back(compiler.Load(path, defines));
+		});
+		double loadMs = NowMs() - start;
+
+		double worstPollMs = 0.0;
+		unsigned int polls = 0;
+		while (compiler.GetPendingCount() > 0)
+		{
+			double pollStart = NowMs();
+			compiler.Poll();
+			worstPollMs = std::max(worstPollMs, NowMs() - pollStart);
+			polls++;
+
+			/* Stands in for the rest of the frame, spinning would starve the worker on small machines */
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		double readyMs = NowMs() - start;
+
+		unsigned int failed = 0;
+		for (const std::shared_ptr<ShaderHandle>& handle : handles)
+			failed += handle->GetStatus() == ShaderHandle::Status::Failed;
+
+		std::cout << name << "\t" << handles.size() << "\t" << loadMs << "\t" << worstPollMs
+			<< "\t" << polls << "\t" << readyMs << "\t" << failed << std::endl;
+	};
+
+	std::cout << "mode\tprograms\tload ms\tworst poll ms\tpolls\tready after ms\tfailed" << std::endl;
+	asyncPass("parallel", ShaderCompiler::Mode::Parallel);
+	asyncPass("worker", ShaderCompiler::Mode::Worker);
+	asyncPass("deferred", ShaderCompiler::Mode::Deferred);
+
+	programCache.SetDirectory(directory);
+	programCache.ResetStats();
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "ShaderCompiler.h"
+
+/*
+ * Creates the four scene shaders variantCount times, each variant with a
+ * different define, the way a material system builds permutations at startup.
+ * Prints the time for three passes: ProgramCache disabled, a cold cache that
+ * compiles and stores every binary and a warm cache that only loads them. The
+ * cold and uncached passes get their own defines so neither sees binaries
+ * from the driver's internal cache. The binaries written are removed after.
+ *
+ * Then loads the same permutations through ShaderCompiler in every available
+ * mode, with the cache disabled, polling in a loop like a frame would, and
+ * prints how long Load and the slowest Poll block against the time until all
+ * programs are ready. workerContext enables the worker mode.
+ */
+void RunShaderCacheBenchmark(ShaderCompiler::ContextBinder workerContext = nullptr, unsigned int variantCount = 16);
\ No newline at end of file
@@ -0,0 +1,309 @@
+#include "ShaderCompiler.h"
+
+#include <iostream>
+
+#include "Renderer.h"
+#include "Profiler.h"
+#include "ProgramCache.h"
+
+static void PrintInfoLog(unsigned int object, bool program, const std::string& what)
+{
+	int length = 0;
+	if (program)
+	{
+		GLCall(glGetProgramiv(object, GL_INFO_LOG_LENGTH, &length));
+	}
+	else
+	{
+		GLCall(glGetShaderiv(object, GL_INFO_LOG_LENGTH, &length));
+	}
+	if (length <= 1)
+		return;
+
+	std::string message(length, '\0');
+	if (program)
+	{
+		GLCall(glGetProgramInfoLog(object, length, &length, &message[0]));
+	}
+	else
+	{
+		GLCall(glGetShaderInfoLog(object, length, &length, &message[0]));
+	}
+
+	std::cout << "Failed to build " << what << " !" << std::endl;
+	std::cout << message.c_str() << std::endl;
+}
+
+ShaderHandle::ShaderHandle(const std::string& filepath, Shader& fallback)
+	: m_FilePath(filepath), m_Status(Status::Compiling), m_Fallback(&fallback)
+{
+}
+
+ShaderCompiler::ShaderCompiler(Shader& fallback, ContextBinder workerContext /*= nullptr*/)
+	: m_Fallback(fallback), m_WorkerContext(workerContext), m_Mode(Mode::Deferred), m_WorkerRunning(false)
+{
+	if (IsModeAvailable(Mode::Parallel))
+		SetMode(Mode::Parallel);
+	else if (IsModeAvailable(Mode::Worker))
+		SetMode(Mode::Worker);
+}
+
+ShaderCompiler::~ShaderCompiler()
+{
+	StopWorker();
+
+	/* Whatever is still compiling is abandoned, its handles keep the fallback */
+	for (const std::shared_ptr<Job>& job : m_Jobs)
+	{
+		GLCall(glDeleteShader(job->VertexShader));
+		GLCall(glDeleteShader(job->FragmentShader));
+		GLCall(glDeleteProgram(job->Program));
+	}
+}
+
+bool ShaderCompiler::IsModeAvailable(Mode mode) const
+{
+	switch (mode)
+	{
+	case Mode::Parallel:
+		return GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+	case Mode::Worker:
+		return (bool)m_WorkerContext;
+	default:
+		return true;
+	}
+}
+
+bool ShaderCompiler::SetMode(Mode mode)
+{
+	if (!m_Jobs.empty() || !IsModeAvailable(mode))
+		return false;
+
+	StopWorker();
+	m_Mode = mode;
+
+	if (mode == Mode::Parallel)
+	{
+		/* 0xFFFFFFFF lets the driver pick the thread count */
+		if (GLEW_KHR_parallel_shader_compile)
+		{
+			GLCall(glMaxShaderCompilerThreadsKHR(0xFFFFFFFF));
+		}
+		else
+		{
+			GLCall(glMaxShaderCompilerThreadsARB(0xFFFFFFFF));
+		}
+	}
+	else if (mode == Mode::Worker)
+	{
+		StartWorker();
+	}
+	return true;
+}
+
+std::shared_ptr<ShaderHandle> ShaderCompiler::Load(const std::string& filepath, const std::vector<std::string>& defines /*= {}*/)
+{
+	PROFILE_SCOPE("ShaderCompiler::Load");
+
+	std::shared_ptr<ShaderHandle> handle(new ShaderHandle(filepath, m_Fallback));
+
+	ProgramCache& programCache = ProgramCache::Get();
+	ShaderProgramSource source = Shader::LoadSource(filepath, defines);
+	unsigned long long programKey = programCache.GetKey(source.VertexSource, source.FragmentSource);
+
+	/* A cached binary loads in a fraction of a compile, there is nothing worth deferring */
+	unsigned int program = programCache.Load(programKey);
+	if (program)
+	{
+		handle->m_Shader = std::make_unique<Shader>(filepath, program, programKey, source);
+		handle->m_Status = ShaderHandle::Status::Ready;
+		return handle;
+	}
+
+	std::shared_ptr<Job> job = std::make_shared<Job>(Job{ handle, std::move(source), programKey, 0, 0, 0, programCache.IsSupported(), false });
+	m_Jobs.push_back(job);
+
+	if (m_Mode == Mode::Worker)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_WorkerQueue.push_back(job);
+		}
+		m_Condition.notify_all();
+	}
+	else
+	{
+		Issue(*job);
+	}
+
+	return handle;
+}
+
+void ShaderCompiler::Poll()
+{
+	PROFILE_SCOPE("ShaderCompiler::Poll");
+
+	bool resolved = false;
+	for (auto it = m_Jobs.begin(); it != m_Jobs.end();)
+	{
+		Job& job = **it;
+
+		bool complete = false;
+		if (m_Mode == Mode::Parallel)
+		{
+			int status = GL_FALSE;
+			GLCall(glGetProgramiv(job.Program, GL_COMPLETION_STATUS_KHR, &status));
+			complete = status == GL_TRUE;
+		}
+		else if (m_Mode == Mode::Worker)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			complete = job.Done;
+		}
+		else
+		{
+			/* Resolving waits for the link, so only the oldest program per frame */
+			complete = !resolved;
+		}
+
+		if (!complete)
+		{
+			++it;
+			continue;
+		}
+
+		Resolve(job);
+		resolved = true;
+		it = m_Jobs.erase(it);
+	}
+}
+
+void ShaderCompiler::Finish()
+{
+	PROFILE_SCOPE("ShaderCompiler::Finish");
+
+	while (!m_Jobs.empty())
+	{
+		Job& job = *m_Jobs.front();
+		if (m_Mode == Mode::Worker)
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [&job] { return job.Done; });
+		}
+
+		Resolve(job);
+		m_Jobs.pop_front();
+	}
+}
+
+void ShaderCompiler::Issue(Job& job)
+{
+	job.Program = glCreateProgram();
+
+	/* Lets ProgramCache read the linked binary back */
+	if (job.Retrievable)
+	{
+		GLCall(glProgramParameteri(job.Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+	}
+
+	const char* vertexSource = job.Source.VertexSource.c_str();
+	job.VertexShader = glCreateShader(GL_VERTEX_SHADER);
+	GLCall(glShaderSource(job.VertexShader, 1, &vertexSource, nullptr));
+	GLCall(glCompileShader(job.VertexShader));
+
+	const char* fragmentSource = job.Source.FragmentSource.c_str();
+	job.FragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	GLCall(glShaderSource(job.FragmentShader, 1, &fragmentSource, nullptr));
+	GLCall(glCompileShader(job.FragmentShader));
+
+	GLCall(glAttachShader(job.Program, job.VertexShader));
+	GLCall(glAttachShader(job.Program, job.FragmentShader));
+	GLCall(glLinkProgram(job.Program));
+}
+
+void ShaderCompiler::Resolve(Job& job)
+{
+	PROFILE_SCOPE("ShaderCompiler::Resolve");
+
+	ShaderHandle& handle = *job.Handle;
+
+	int linked = GL_FALSE;
+	GLCall(glGetProgramiv(job.Program, GL_LINK_STATUS, &linked));
+	if (linked == GL_FALSE)
+	{
+		PrintInfoLog(job.VertexShader, false, handle.m_FilePath + " vertex shader");
+		PrintInfoLog(job.FragmentShader, false, handle.m_FilePath + " fragment shader");
+		PrintInfoLog(job.Program, true, handle.m_FilePath);
+	}
+
+	GLCall(glDeleteShader(job.VertexShader));
+	GLCall(glDeleteShader(job.FragmentShader));
+
+	if (linked == GL_FALSE)
+	{
+		GLCall(glDeleteProgram(job.Program));
+		handle.m_Status = ShaderHandle::Status::Failed;
+		return;
+	}
+
+	ProgramCache::Get().Store(job.ProgramKey, job.Program);
+	handle.m_Shader = std::make_unique<Shader>(handle.m_FilePath, job.Program, job.ProgramKey, job.Source);
+	handle.m_Status = ShaderHandle::Status::Ready;
+}
+
+void ShaderCompiler::StartWorker()
+{
+	if (m_WorkerRunning)
+		return;
+
+	m_WorkerRunning = true;
+	m_Worker = std::thread(&ShaderCompiler::RunWorker, this);
+}
+
+void ShaderCompiler::StopWorker()
+{
+	if (!m_WorkerRunning)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_WorkerRunning = false;
+		m_WorkerQueue.clear();
+	}
+	m_Condition.notify_all();
+	m_Worker.join();
+}
+
+void ShaderCompiler::RunWorker()
+{
+	m_WorkerContext(true);
+
+	while (true)
+	{
+		std::shared_ptr<Job> job;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [this] { return !m_WorkerQueue.empty() || !m_WorkerRunning; });
+			if (!m_WorkerRunning)
+				break;
+
+			job = m_WorkerQueue.front();
+			m_WorkerQueue.pop_front();
+		}
+
+		Issue(*job);
+
+		/* The status query waits for the link, glFinish makes the program visible to the main context */
+		int linked;
+		GLCall(glGetProgramiv(job->Program, GL_LINK_STATUS, &linked));
+		GLCall(glFinish());
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			job->Done = true;
+		}
+		m_Condition.notify_all();
+	}
+
+	m_WorkerContext(false);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Shader.h"
+
+/* A program that may still be compiling, handed out by ShaderCompiler::Load */
+class ShaderHandle
+{
+public:
+	enum class Status
+	{
+		Compiling, Ready, Failed
+	};
+
+	inline Status GetStatus() const { return m_Status; }
+	inline bool IsReady() const { return m_Status == Status::Ready; }
+	inline const std::string& GetFilePath() const { return m_FilePath; }
+
+	/* The linked shader once ready, the compiler's fallback while compiling or after a failure */
+	inline Shader& Get() const { return m_Shader ? *m_Shader : *m_Fallback; }
+private:
+	friend class ShaderCompiler;
+
+	ShaderHandle(const std::string& filepath, Shader& fallback);
+private:
+	std::string m_FilePath;
+	Status m_Status;
+	std::unique_ptr<Shader> m_Shader;
+	Shader* m_Fallback;
+};
+
+/*
+ * Creates programs without blocking the frame that asks for them. Load reads
+ * the source and either takes the program from ProgramCache or issues the
+ * compile; Poll, called once per frame, turns finished programs into Shaders.
+ * Until then ShaderHandle::Get returns the fallback shader, so loading a level
+ * with many shaders draws placeholders instead of stalling.
+ *
+ * Three ways to compile, picked in this order:
+ *   Parallel  KHR/ARB_parallel_shader_compile: every compile and link is issued
+ *             up front and Poll only reads GL_COMPLETION_STATUS_KHR, which
+ *             never waits for the driver's compiler threads
+ *   Worker    a thread with its own context sharing objects with the main one
+ *             compiles and links, Poll collects the results
+ *   Deferred  compiles and links are issued up front on the calling thread;
+ *             without a way to ask whether they are done, Poll finishes one
+ *             program per frame so a stall is bounded by a single link
+ *
+ * The compiler and the fallback shader must outlive every handle.
+ */
+class ShaderCompiler
+{
+public:
+	enum class Mode
+	{
+		Parallel, Worker, Deferred
+	};
+
+	/* Makes a context sharing objects with the main context current on the calling thread (true) or releases it (false) */
+	using ContextBinder = std::function<void(bool current)>;
+
+	ShaderCompiler(Shader& fallback, ContextBinder workerContext = nullptr);
+	~ShaderCompiler();
+
+	std::shared_ptr<ShaderHandle> Load(const std::string& filepath, const std::vector<std::string>& defines = {});
+
+	/* Call on the thread owning the main context, once per frame */
+	void Poll();
+	/* Blocks until no program is compiling, e.g. behind a loading screen */
+	void Finish();
+
+	/* Only while nothing is compiling; false when the mode is not available */
+	bool SetMode(Mode mode);
+	inline Mode GetMode() const { return m_Mode; }
+	bool IsModeAvailable(Mode mode) const;
+
+	inline unsigned int GetPendingCount() const { return (unsigned int)m_Jobs.size(); }
+private:
+	struct Job
+	{
+		std::shared_ptr<ShaderHandle> Handle;
+		ShaderProgramSource Source;
+		unsigned long long ProgramKey;
+		unsigned int Program;
+		unsigned int VertexShader;
+		unsigned int FragmentShader;
+		/* Read once on the main thread, ProgramCache is not thread safe */
+		bool Retrievable;
+		/* Set by the worker once the program is linked or failed */
+		bool Done;
+	};
+
+	/* Issues both compiles and the link without asking for any result */
+	static void Issue(Job& job);
+	/* Program must be complete; reports errors and deletes the stage shaders */
+	void Resolve(Job& job);
+
+	void StartWorker();
+	void StopWorker();
+	void RunWorker();
+private:
+	Shader& m_Fallback;
+	ContextBinder m_WorkerContext;
+	Mode m_Mode;
+
+	/* In submission order; in Worker mode shared with the worker under m_Mutex */
+	std::deque<std::shared_ptr<Job>> m_Jobs;
+
+	std::thread m_Worker;
+	std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+	std::deque<std::shared_ptr<Job>> m_WorkerQueue;
+	bool m_WorkerRunning;
+};
\ No newline at end of file
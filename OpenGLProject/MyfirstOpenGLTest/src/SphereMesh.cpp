@@ -0,0 +1,32 @@
+#include "SphereMesh.h"
+
+#include <cmath>
+
+void BuildSphere(unsigned int segments, std::vector<SphereVertex>& vertices, std::vector<unsigned int>& indices)
+{
+	const float Pi = 3.14159265f;
+
+	for (unsigned int y = 0; y <= segments; y++)
+	{
+		for (unsigned int x = 0; x <= segments; x++)
+		{
+			float u = (float)x / segments;
+			float v = (float)y / segments;
+			float theta = u * 2.0f * Pi;
+			float phi = v * Pi;
+			float nx = std::cos(theta) * std::sin(phi);
+			float ny = std::cos(phi);
+			float nz = std::sin(theta) * std::sin(phi);
+			vertices.push_back({ { nx, ny, nz }, { u, v }, { nx, ny, nz } });
+		}
+	}
+
+	for (unsigned int y = 0; y < segments; y++)
+	{
+		for (unsigned int x = 0; x < segments; x++)
+		{
+			unsigned int i = y * (segments + 1) + x;
+			indices.insert(indices.end(), { i, i + segments + 1, i + 1, i + 1, i + segments + 1, i + segments + 2 });
+		}
+	}
+}
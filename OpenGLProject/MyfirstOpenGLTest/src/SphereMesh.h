@@ -0,0 +1,17 @@
+#pragma once
+
+#include <vector>
+
+struct SphereVertex
+{
+	float Position[3];
+	float TexCoord[2];
+	float Normal[3];
+};
+
+/*
+ * A unit UV sphere of segments x segments quads, the test mesh of the
+ * benchmarks. Every row repeats its first vertex at u = 1 and the poles are
+ * rows of vertices at one position, like a mesh exported with a UV seam.
+ */
+void BuildSphere(unsigned int segments, std::vector<SphereVertex>& vertices, std::vector<unsigned int>& indices);
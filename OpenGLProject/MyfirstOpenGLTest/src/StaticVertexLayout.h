@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+
+#include <GL/glew.h>
+
+#include "glm/glm.hpp"
+
+/*
+ * Compile-time counterpart of VertexBufferLayout, generated from a vertex struct:
+ *
+ *   struct Vertex { glm::vec3 Position; glm::vec2 TexCoord; };
+ *   constexpr auto VertexLayout = MakeVertexLayout<Vertex>(
+ *       VERTEX_ATTRIBUTE(Vertex, Position),
+ *       VERTEX_ATTRIBUTE(Vertex, TexCoord));
+ *
+ * Offsets come from offsetof and the stride from sizeof, so padding and member
+ * order cannot drift from the struct. VertexArray::Addbuffer expands the
+ * attributes at compile time and allocates nothing. Types without a C++
+ * counterpart (GL_HALF_FLOAT, GL_INT_2_10_10_10_REV) use VertexAttribute::Make.
+ */
+
+/* GL type, component count and normalization of a C++ attribute type, matching VertexBufferLayout::Push<T> */
+template<typename T>
+struct VertexAttributeTraits
+{
+	static_assert(sizeof(T) == 0, "VertexAttributeTraits: unsupported attribute type");
+};
+
+template<unsigned int TypeValue, unsigned int CountValue, bool NormalizedValue>
+struct VertexAttributeTraitsBase
+{
+	static constexpr unsigned int Type = TypeValue;
+	static constexpr unsigned int Count = CountValue;
+	static constexpr bool Normalized = NormalizedValue;
+};
+
+template<> struct VertexAttributeTraits<float> : VertexAttributeTraitsBase<GL_FLOAT, 1, false> {};
+template<> struct VertexAttributeTraits<int> : VertexAttributeTraitsBase<GL_INT, 1, false> {};
+template<> struct VertexAttributeTraits<unsigned int> : VertexAttributeTraitsBase<GL_UNSIGNED_INT, 1, false> {};
+template<> struct VertexAttributeTraits<unsigned char> : VertexAttributeTraitsBase<GL_UNSIGNED_BYTE, 1, true> {};
+template<> struct VertexAttributeTraits<short> : VertexAttributeTraitsBase<GL_SHORT, 1, true> {};
+template<> struct VertexAttributeTraits<unsigned short> : VertexAttributeTraitsBase<GL_UNSIGNED_SHORT, 1, true> {};
+
+template<typename T, size_t N>
+struct VertexAttributeTraits<T[N]>
+	: VertexAttributeTraitsBase<VertexAttributeTraits<T>::Type, (unsigned int)N * VertexAttributeTraits<T>::Count, VertexAttributeTraits<T>::Normalized> {};
+
+template<typename T, glm::precision P>
+struct VertexAttributeTraits<glm::tvec2<T, P>> : VertexAttributeTraits<T[2]> {};
+
+template<typename T, glm::precision P>
+struct VertexAttributeTraits<glm::tvec3<T, P>> : VertexAttributeTraits<T[3]> {};
+
+template<typename T, glm::precision P>
+struct VertexAttributeTraits<glm::tvec4<T, P>> : VertexAttributeTraits<T[4]> {};
+
+/* A per-instance mat4 spans four locations */
+template<typename T, glm::precision P>
+struct VertexAttributeTraits<glm::tmat4x4<T, P>> : VertexAttributeTraits<T[16]> {};
+
+struct VertexAttribute
+{
+	unsigned int Type;
+	unsigned int Count;
+	bool Normalized;
+	unsigned int Offset;
+	/* 0 advances per vertex, N advances once every N instances */
+	unsigned int Divisor;
+	/* Relative to the first location of the layout, assigned by MakeVertexLayout */
+	unsigned int Location;
+
+	static constexpr VertexAttribute Make(unsigned int type, unsigned int count, bool normalized, unsigned int offset, unsigned int divisor = 0)
+	{
+		return { type, count, normalized, offset, divisor, 0 };
+	}
+
+	template<typename T>
+	static constexpr VertexAttribute Of(unsigned int offset, unsigned int divisor = 0)
+	{
+		return Make(VertexAttributeTraits<T>::Type, VertexAttributeTraits<T>::Count, VertexAttributeTraits<T>::Normalized, offset, divisor);
+	}
+};
+
+#define VERTEX_ATTRIBUTE(Vertex, Member) VertexAttribute::Of<decltype(Vertex::Member)>((unsigned int)offsetof(Vertex, Member))
+#define VERTEX_ATTRIBUTE_INSTANCED(Vertex, Member, Divisor) VertexAttribute::Of<decltype(Vertex::Member)>((unsigned int)offsetof(Vertex, Member), Divisor)
+
+template<size_t N>
+struct StaticVertexLayout
+{
+	VertexAttribute Attributes[N];
+	unsigned int Stride;
+	unsigned int LocationCount;
+};
+
+template<typename Vertex, typename... AttributeTypes>
+constexpr StaticVertexLayout<sizeof...(AttributeTypes)> MakeVertexLayout(AttributeTypes... attributes)
+{
+	StaticVertexLayout<sizeof...(AttributeTypes)> layout = { { attributes... }, (unsigned int)sizeof(Vertex), 0 };
+	for (size_t i = 0; i < sizeof...(AttributeTypes); i++)
+	{
+		layout.Attributes[i].Location = layout.LocationCount;
+		layout.LocationCount += (layout.Attributes[i].Count + 3) / 4;
+	}
+	return layout;
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "StreamingVertexBuffer.h"
+#include "Renderer.h"
+
+StreamingVertexBuffer::StreamingVertexBuffer(unsigned int vertexSize, unsigned int verticesPerRegion)
+	: m_VertexSize(vertexSize), m_RegionVertices(verticesPerRegion), m_Persistent(nullptr),
+	m_Region(0), m_Head(0), m_MappedVertex(0), m_Mapped(false)
+{
+	for (unsigned int i = 0; i < RegionCount; i++)
+		m_Fences[i] = nullptr;
+
+	GLsizeiptr size = (GLsizeiptr)m_VertexSize * m_RegionVertices * RegionCount;
+
+	GLCall(glGenBuffers(1, &m_RendererID));
+	Bind();
+
+	if (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage)
+	{
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		GLCall(glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags));
+		GLCall(m_Persistent = (char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+	}
+	else
+	{
+		GLCall(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW));
+	}
+}
+
+StreamingVertexBuffer::~StreamingVertexBuffer()
+{
+	for (unsigned int i = 0; i < RegionCount; i++)
+	{
+		if (m_Fences[i])
+		{
+			GLCall(glDeleteSync(m_Fences[i]));
+		}
+	}
+
+	/* Deleting the buffer also releases a persistent mapping */
+	GLState::Get().OnDeleteBuffer(m_RendererID);
+	GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void* StreamingVertexBuffer::Map(unsigned int vertexCount, int& baseVertex)
+{
+	ASSERT(!m_Mapped);
+	ASSERT(vertexCount <= m_RegionVertices);
+
+	if (m_Persistent)
+	{
+		/* Does not fit behind the last write: fence what is there and take the next region */
+		if (m_Head + vertexCount > (m_Region + 1) * m_RegionVertices)
+			NextRegion();
+	}
+	else if (m_Head + vertexCount > m_RegionVertices * RegionCount)
+	{
+		/* Out of space: let the driver hand us a fresh store instead of waiting for the old one */
+		Bind();
+		GLCall(glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)m_VertexSize * m_RegionVertices * RegionCount, nullptr, GL_STREAM_DRAW));
+		m_Head = 0;
+		m_Stats.Orphans++;
+	}
+
+	m_Mapped = true;
+	m_MappedVertex = m_Head;
+	m_Stats.Maps++;
+	baseVertex = (int)m_Head;
+
+	if (m_Persistent)
+		return m_Persistent + (size_t)m_Head * m_VertexSize;
+
+	/* Nothing the GPU may still read lies behind m_Head, so the driver need not synchronise */
+	Bind();
+	GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
+	void* data;
+	GLCall(data = glMapBufferRange(GL_ARRAY_BUFFER, (GLintptr)m_Head * m_VertexSize, (GLsizeiptr)vertexCount * m_VertexSize, access));
+	return data;
+}
+
+unsigned int StreamingVertexBuffer::GetAvailableVertices() const
+{
+	if (m_Persistent)
+		return (m_Region + 1) * m_RegionVertices - m_Head;
+
+	return m_RegionVertices * RegionCount - m_Head;
+}
+
+void StreamingVertexBuffer::Unmap(unsigned int vertexCount)
+{
+	ASSERT(m_Mapped);
+	m_Mapped = false;
+
+	if (!m_Persistent)
+	{
+		Bind();
+		if (vertexCount)
+		{
+			GLCall(glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)vertexCount * m_VertexSize));
+		}
+		GLCall(glUnmapBuffer(GL_ARRAY_BUFFER));
+	}
+
+	m_Head = m_MappedVertex + vertexCount;
+	m_Stats.BytesWritten += vertexCount * m_VertexSize;
+}
+
+void StreamingVertexBuffer::EndFrame()
+{
+	ASSERT(!m_Mapped);
+
+	if (m_Persistent)
+		NextRegion();
+}
+
+void StreamingVertexBuffer::NextRegion()
+{
+	/* Everything drawn from this region so far has been submitted, fence it */
+	if (m_Fences[m_Region])
+	{
+		GLCall(glDeleteSync(m_Fences[m_Region]));
+	}
+	GLCall(m_Fences[m_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+	m_Region = (m_Region + 1) % RegionCount;
+	m_Head = m_Region * m_RegionVertices;
+
+	GLsync fence = m_Fences[m_Region];
+	if (!fence)
+		return;
+
+	GLenum result;
+	GLCall(result = glClientWaitSync(fence, 0, 0));
+	if (result == GL_TIMEOUT_EXPIRED)
+	{
+		/* The GPU is still reading the region we are about to overwrite */
+		m_Stats.Waits++;
+		do
+		{
+			GLCall(result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000));
+		} while (result == GL_TIMEOUT_EXPIRED);
+	}
+
+	GLCall(glDeleteSync(fence));
+	m_Fences[m_Region] = nullptr;
+}
+
+void StreamingVertexBuffer::Bind() const
+{
+	GLState::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+}
+
+void StreamingVertexBuffer::UnBind() const
+{
+	GLState::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
+}
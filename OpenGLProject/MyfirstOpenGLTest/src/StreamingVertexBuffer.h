@@ -0,0 +1,73 @@
+#pragma once
+
+#include <GL/glew.h>
+
+/*
+ * Vertex buffer for data that is rewritten every frame. The store is split
+ * into RegionCount regions of verticesPerRegion vertices each. Map() hands out
+ * a pointer straight into the buffer, the caller writes its vertices there and
+ * draws them with the returned base vertex once Unmap() has been called.
+ * Writes are packed behind each other, so several Map()s per frame share a
+ * region as long as they fit in what GetAvailableVertices() reports.
+ *
+ * With GL 4.4 / ARB_buffer_storage the store is mapped once, persistently and
+ * coherently, and each region is protected by a fence: a region is only
+ * written again after the GPU has passed the fence placed behind its draws.
+ * Without it every Map() is a glMapBufferRange(UNSYNCHRONIZED) behind the
+ * last write and the store is orphaned when it runs out of space.
+ */
+class StreamingVertexBuffer
+{
+public:
+	static const unsigned int RegionCount = 3;
+
+	struct Stats
+	{
+		unsigned int Maps = 0;
+		/* Times a region was still in use by the GPU (persistent path) */
+		unsigned int Waits = 0;
+		/* Times the store was reallocated because it was full (fallback path) */
+		unsigned int Orphans = 0;
+		unsigned int BytesWritten = 0;
+	};
+
+	StreamingVertexBuffer(unsigned int vertexSize, unsigned int verticesPerRegion);
+	~StreamingVertexBuffer();
+
+	/* Space for up to vertexCount vertices, vertexCount must not exceed a region */
+	void* Map(unsigned int vertexCount, int& baseVertex);
+	/* Vertices a Map() can take before it has to move to the next region or orphan the store */
+	unsigned int GetAvailableVertices() const;
+	/* Ends the write started by Map(), only the first vertexCount vertices are kept */
+	void Unmap(unsigned int vertexCount);
+
+	/* Fences the region written this frame and moves on to the next one */
+	void EndFrame();
+
+	void Bind() const;
+	void UnBind() const;
+
+	inline bool IsPersistent() const { return m_Persistent != nullptr; }
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+	inline unsigned int GetVertexSize() const { return m_VertexSize; }
+	inline const Stats& GetStats() const { return m_Stats; }
+	inline void ResetStats() { m_Stats = Stats(); }
+private:
+	void NextRegion();
+private:
+	unsigned int m_RendererID;
+	unsigned int m_VertexSize;
+	unsigned int m_RegionVertices;
+
+	/* Persistent mapping of the whole store, nullptr on the fallback path */
+	char* m_Persistent;
+	GLsync m_Fences[RegionCount];
+	unsigned int m_Region;
+
+	/* Next free vertex, counted from the start of the store */
+	unsigned int m_Head;
+	unsigned int m_MappedVertex;
+	bool m_Mapped;
+
+	Stats m_Stats;
+};
\ No newline at end of file
@@ -1,24 +1,54 @@
 #include "Texture.h"
 
+#include "Profiler.h"
+#include "GLDebug.h"
+
 #include "stb_image/stb_image.h"
 
 Texture::Texture(const std::string& path)
 	: m_RendererID(0), m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0)
 {
+	PROFILE_SCOPE("Texture::Texture");
+
 	/* Flip the image vertically */
 	stbi_set_flip_vertically_on_load(1);
-	m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
+	{
+		PROFILE_SCOPE("stbi_load");
+		m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
+	}
+
+	if (GLState::Get().UseDirectStateAccess())
+	{
+		/* Immutable single level storage, nothing gets bound */
+		GLCall(glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID));
+		GLDebug::Get().Label(GL_TEXTURE, m_RendererID, m_FilePath);
 
-	GLCall(glGenTextures(1, &m_RendererID));
-	GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+		GLCall(glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+		GLCall(glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+		GLCall(glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+		GLCall(glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
 
-	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+		/* A failed load leaves the texture without storage, like a 0x0 glTexImage2D */
+		if (m_LocalBuffer)
+		{
+			GLCall(glTextureStorage2D(m_RendererID, 1, GL_RGBA8, m_Width, m_Height));
+			GLCall(glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
+		}
+	}
+	else
+	{
+		GLCall(glGenTextures(1, &m_RendererID));
+		GLState::Get().BindTexture(GL_TEXTURE_2D, m_RendererID);
+		GLDebug::Get().Label(GL_TEXTURE, m_RendererID, m_FilePath);
 
-	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
-	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+		GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
+		GLState::Get().BindTexture(GL_TEXTURE_2D, 0);
+	}
 
 	if (m_LocalBuffer)
 	{
@@ -29,16 +59,16 @@ Texture::Texture(const std::string& path)
 
 Texture::~Texture()
 {
+	GLState::Get().OnDeleteTexture(m_RendererID);
 	GLCall(glDeleteTextures(1, &m_RendererID));
 }
 
 void Texture::Bind(unsigned int slot /*= 0*/) const
 {
-	GLCall(glActiveTexture(GL_TEXTURE0 + slot));
-	GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+	GLState::Get().BindTextureUnit(slot, GL_TEXTURE_2D, m_RendererID);
 }
 
 void Texture::UnBind() const
 {
-	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+	GLState::Get().BindTexture(GL_TEXTURE_2D, 0);
 }
@@ -18,5 +18,6 @@ public:
 
 	inline int GetWidth() const { return m_Width; }
 	inline int GetHeight() const { return m_Height; }
+	inline unsigned int GetRendererID() const { return m_RendererID; }
 protected:
 };
\ No newline at end of file
@@ -0,0 +1,355 @@
+#include "UniformTable.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include "Renderer.h"
+
+static bool IsIdentifierChar(char c)
+{
+	return std::isalnum((unsigned char)c) || c == '_';
+}
+
+static std::string LastIdentifier(const std::string& text)
+{
+	size_t end = text.size();
+	while (end > 0 && !IsIdentifierChar(text[end - 1]))
+		end--;
+
+	size_t begin = end;
+	while (begin > 0 && IsIdentifierChar(text[begin - 1]))
+		begin--;
+
+	return text.substr(begin, end - begin);
+}
+
+/*
+ * The source without comments and without the lines inside #if, #ifdef and
+ * #ifndef blocks. Whether such a block is compiled depends on the defines, so
+ * its declarations are left out of the inactive uniform check.
+ */
+static std::string GetUnconditionalCode(const std::string& source)
+{
+	std::string code;
+	code.reserve(source.size());
+	size_t position = 0;
+	while (position < source.size())
+	{
+		if (source.compare(position, 2, "//") == 0)
+		{
+			position = source.find('\n', position);
+			if (position == std::string::npos)
+				break;
+		}
+		else if (source.compare(position, 2, "/*") == 0)
+		{
+			size_t end = source.find("*/", position + 2);
+			if (end == std::string::npos)
+				break;
+
+			/* Keeps the line breaks, so a directive after the comment still starts its line */
+			code += ' ';
+			code.append(std::count(source.begin() + position, source.begin() + end, '\n'), '\n');
+			position = end + 2;
+		}
+		else
+		{
+			code += source[position++];
+		}
+	}
+
+	std::stringstream stream(code);
+	std::string line;
+	std::string result;
+	int depth = 0;
+	while (std::getline(stream, line))
+	{
+		size_t first = line.find_first_not_of(" \t");
+		if (first != std::string::npos && line[first] == '#')
+		{
+			size_t directive = line.find_first_not_of(" \t", first + 1);
+			if (directive != std::string::npos && line.compare(directive, 2, "if") == 0)
+				depth++;
+			else if (directive != std::string::npos && line.compare(directive, 5, "endif") == 0 && depth > 0)
+				depth--;
+			continue;
+		}
+
+		if (depth == 0)
+			result += line + '\n';
+	}
+	return result;
+}
+
+/* Names of the uniforms and uniform blocks a GLSL source declares, arrays without their size */
+static void ParseDeclarations(const std::string& source, std::vector<std::string>& uniforms, std::vector<std::string>& blocks)
+{
+	size_t position = 0;
+	while ((position = source.find("uniform", position)) != std::string::npos)
+	{
+		size_t start = position + 7;
+		bool keyword = (position == 0 || !IsIdentifierChar(source[position - 1])) && start < source.size() && !IsIdentifierChar(source[start]);
+		position = start;
+		if (!keyword)
+			continue;
+
+		size_t end = source.find_first_of(";{", start);
+		if (end == std::string::npos)
+			break;
+
+		if (source[end] == '{')
+		{
+			/* uniform Name { ... }; the members are read through the block */
+			blocks.push_back(LastIdentifier(source.substr(start, end - start)));
+			position = source.find('}', end);
+			continue;
+		}
+
+		/* uniform vec4 a, b[2]; */
+		std::string declaration = source.substr(start, end - start);
+		size_t begin = 0;
+		while (begin <= declaration.size())
+		{
+			size_t comma = declaration.find(',', begin);
+			std::string part = declaration.substr(begin, comma == std::string::npos ? std::string::npos : comma - begin);
+			std::string name = LastIdentifier(part.substr(0, part.find('[')));
+			if (!name.empty())
+				uniforms.push_back(name);
+
+			if (comma == std::string::npos)
+				break;
+			begin = comma + 1;
+		}
+		position = end;
+	}
+}
+
+void UniformTable::Reflect(unsigned int program, const std::string& label, const std::string& vertexSource, const std::string& fragmentSource)
+{
+	m_Label = label;
+	m_Uniforms.clear();
+	m_ByHash.clear();
+	m_Blocks.clear();
+	m_DirtyCount = 0;
+
+	int count = 0;
+	int maxLength = 0;
+	GLCall(glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count));
+	GLCall(glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+
+	std::vector<char> name(maxLength + 1);
+	for (int i = 0; i < count; i++)
+	{
+		int length = 0;
+		int size = 0;
+		unsigned int type = 0;
+		GLCall(glGetActiveUniform(program, (unsigned int)i, (int)name.size(), &length, &size, &type, name.data()));
+
+		/* Members of uniform blocks have no location, they are set through the block's buffer */
+		int location;
+		GLCall(location = glGetUniformLocation(program, name.data()));
+		if (location == -1)
+			continue;
+
+		std::string uniformName(name.data(), length);
+		if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+			uniformName.resize(uniformName.size() - 3);
+
+		Add(ShaderUniform(UniformID::HashName(uniformName.c_str()), location, type, size, uniformName));
+	}
+
+	GLCall(glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &count));
+	GLCall(glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength));
+
+	name.resize(maxLength + 1);
+	for (int i = 0; i < count; i++)
+	{
+		int length = 0;
+		int binding = 0;
+		int dataSize = 0;
+		GLCall(glGetActiveUniformBlockName(program, (unsigned int)i, (int)name.size(), &length, name.data()));
+		GLCall(glGetActiveUniformBlockiv(program, (unsigned int)i, GL_UNIFORM_BLOCK_BINDING, &binding));
+		GLCall(glGetActiveUniformBlockiv(program, (unsigned int)i, GL_UNIFORM_BLOCK_DATA_SIZE, &dataSize));
+
+		std::string blockName(name.data(), length);
+		m_Blocks.push_back({ UniformID::HashName(blockName.c_str()), (unsigned int)i, binding, dataSize, blockName });
+	}
+
+	std::sort(m_Blocks.begin(), m_Blocks.end(), [](const ShaderUniformBlock& a, const ShaderUniformBlock& b) { return a.Hash < b.Hash; });
+
+	/* Two names with one hash would make one of them unreachable */
+	for (size_t i = 1; i < m_ByHash.size(); i++)
+		ASSERT(m_ByHash[i - 1].Hash != m_ByHash[i].Hash);
+
+	std::vector<std::string> declaredUniforms;
+	std::vector<std::string> declaredBlocks;
+	ParseDeclarations(GetUnconditionalCode(vertexSource), declaredUniforms, declaredBlocks);
+	ParseDeclarations(GetUnconditionalCode(fragmentSource), declaredUniforms, declaredBlocks);
+
+	for (const std::string& declared : declaredUniforms)
+	{
+		unsigned int hash = UniformID::HashName(declared.c_str());
+		if (Find(hash) != NotFound)
+			continue;
+
+		std::cout << "Warning: uniform '" << declared << "' is not active in " << m_Label << '\n';
+		Add(ShaderUniform(hash, -1, 0, 0, declared));
+	}
+
+	for (const std::string& declared : declaredBlocks)
+	{
+		if (!FindBlock(declared.c_str()))
+			std::cout << "Warning: uniform block '" << declared << "' is not active in " << m_Label << '\n';
+	}
+}
+
+UniformHandle UniformTable::GetHandle(UniformID id)
+{
+	unsigned int index = Find(id.Hash);
+	if (index == NotFound)
+	{
+		/* Remembered with location -1, so a misspelled name is reported once and not every frame */
+		std::cout << "Warning: uniform '" << id.Name << "' doesn't exist in " << m_Label << "!\n";
+		index = Add(ShaderUniform(id.Hash, -1, 0, 0, id.Name));
+	}
+
+#ifdef _DEBUG
+	/* Release builds trust the hash; another name with the same hash would silently set this uniform */
+	ASSERT(m_Uniforms[index].Name == id.Name);
+#endif
+
+	return { index };
+}
+
+int UniformTable::GetLocation(UniformID id)
+{
+	return GetLocation(GetHandle(id));
+}
+
+const ShaderUniformBlock* UniformTable::FindBlock(UniformID id) const
+{
+	auto it = std::lower_bound(m_Blocks.begin(), m_Blocks.end(), id.Hash,
+		[](const ShaderUniformBlock& block, unsigned int hash) { return block.Hash < hash; });
+	return it != m_Blocks.end() && it->Hash == id.Hash ? &*it : nullptr;
+}
+
+static size_t GetValueSize(UniformValueType type)
+{
+	switch (type)
+	{
+	case UniformValueType::Float4:	return 4 * sizeof(float);
+	case UniformValueType::Mat4:	return 16 * sizeof(float);
+	default:						return 4;
+	}
+}
+
+void UniformTable::Set(UniformHandle handle, UniformValueType type, int count, const void* value)
+{
+	ASSERT(handle.Index < m_Uniforms.size());
+
+	Stats& stats = GetStats();
+	ShaderUniform& uniform = m_Uniforms[handle.Index];
+	if (uniform.Location == -1)
+	{
+		stats.Skipped++;
+		return;
+	}
+
+	size_t size = (size_t)count * GetValueSize(type);
+	if (uniform.HasValue && uniform.ValueType == type && uniform.ValueCount == count && std::memcmp(uniform.Value.data(), value, size) == 0)
+	{
+		stats.Skipped++;
+		return;
+	}
+
+	/* Reuses the storage of the previous value, only the first set allocates */
+	const unsigned char* bytes = (const unsigned char*)value;
+	uniform.Value.assign(bytes, bytes + size);
+	uniform.ValueType = type;
+	uniform.ValueCount = count;
+	uniform.HasValue = true;
+
+	if (uniform.Dirty)
+	{
+		/* The pending value never reaches GL */
+		stats.Skipped++;
+		return;
+	}
+	uniform.Dirty = true;
+	m_DirtyCount++;
+}
+
+void UniformTable::Flush()
+{
+	if (m_DirtyCount == 0)
+		return;
+
+	Stats& stats = GetStats();
+	for (ShaderUniform& uniform : m_Uniforms)
+	{
+		if (!uniform.Dirty)
+			continue;
+
+		switch (uniform.ValueType)
+		{
+		case UniformValueType::Int:
+			GLCall(glUniform1iv(uniform.Location, uniform.ValueCount, (const int*)uniform.Value.data()));
+			break;
+		case UniformValueType::Float:
+			GLCall(glUniform1fv(uniform.Location, uniform.ValueCount, (const float*)uniform.Value.data()));
+			break;
+		case UniformValueType::Float4:
+			GLCall(glUniform4fv(uniform.Location, uniform.ValueCount, (const float*)uniform.Value.data()));
+			break;
+		case UniformValueType::Mat4:
+			GLCall(glUniformMatrix4fv(uniform.Location, uniform.ValueCount, GL_FALSE, (const float*)uniform.Value.data()));
+			break;
+		}
+
+		uniform.Dirty = false;
+		stats.Issued++;
+	}
+	m_DirtyCount = 0;
+}
+
+void UniformTable::Invalidate()
+{
+	for (ShaderUniform& uniform : m_Uniforms)
+	{
+		if (!uniform.Dirty)
+			uniform.HasValue = false;
+	}
+}
+
+UniformTable::Stats& UniformTable::GetStats()
+{
+	static thread_local Stats s_Stats;
+	return s_Stats;
+}
+
+void UniformTable::ResetStats()
+{
+	GetStats() = Stats();
+}
+
+unsigned int UniformTable::Find(unsigned int hash) const
+{
+	auto it = std::lower_bound(m_ByHash.begin(), m_ByHash.end(), hash,
+		[](const HashIndex& entry, unsigned int value) { return entry.Hash < value; });
+	return it != m_ByHash.end() && it->Hash == hash ? it->Index : NotFound;
+}
+
+unsigned int UniformTable::Add(const ShaderUniform& uniform)
+{
+	/* Appended, so the handles already given out stay valid */
+	unsigned int index = (unsigned int)m_Uniforms.size();
+	m_Uniforms.push_back(uniform);
+
+	HashIndex entry = { uniform.Hash, index };
+	m_ByHash.insert(std::upper_bound(m_ByHash.begin(), m_ByHash.end(), entry,
+		[](const HashIndex& a, const HashIndex& b) { return a.Hash < b.Hash; }), entry);
+	return index;
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/*
+ * Names a uniform by a 32 bit FNV-1a hash computed at compile time, so a
+ * string literal passed to a uniform setter costs no allocation and no string
+ * hashing. Declare frequently used names as constants to be sure the hash is
+ * folded even in unoptimized builds:
+ *
+ *   static constexpr UniformID s_MVPUniform = "u_MVP";
+ */
+struct UniformID
+{
+	unsigned int Hash;
+	/* Not copied, only read for warnings */
+	const char* Name;
+
+	constexpr UniformID(const char* name)
+		: Hash(HashName(name)), Name(name)
+	{
+	}
+
+	static constexpr unsigned int HashName(const char* name)
+	{
+		unsigned int hash = 2166136261u;
+		while (*name)
+			hash = (hash ^ (unsigned char)*name++) * 16777619u;
+		return hash;
+	}
+};
+
+/*
+ * A uniform of one program by its index in that program's UniformTable, from
+ * UniformTable::GetHandle or Shader::GetUniformHandle. Setters taking a handle
+ * index the table directly instead of searching it by hash.
+ */
+struct UniformHandle
+{
+	unsigned int Index;
+};
+
+/* The glUniform* call a value is uploaded with, chosen by the setter like before */
+enum class UniformValueType
+{
+	Int, Float, Float4, Mat4
+};
+
+struct ShaderUniform
+{
+	unsigned int Hash;
+	/* -1 for uniforms declared in the source that the linker removed */
+	int Location;
+	unsigned int Type;
+	/* Element count of arrays, reflected under the name without [0] */
+	int Size;
+	std::string Name;
+
+	/* Shadow of the last value set: what the program holds, or will hold after the next flush */
+	std::vector<unsigned char> Value;
+	UniformValueType ValueType = UniformValueType::Int;
+	int ValueCount = 0;
+	bool HasValue = false;
+	bool Dirty = false;
+
+	ShaderUniform(unsigned int hash, int location = -1, unsigned int type = 0, int size = 0, const std::string& name = std::string())
+		: Hash(hash), Location(location), Type(type), Size(size), Name(name)
+	{
+	}
+};
+
+struct ShaderUniformBlock
+{
+	unsigned int Hash;
+	unsigned int Index;
+	int Binding;
+	int DataSize;
+	std::string Name;
+};
+
+/*
+ * Every active uniform and uniform block of a linked program, read once after
+ * link. Uniforms keep the index they were registered at, which is their
+ * UniformHandle; a UniformID is resolved by a binary search over the hashes,
+ * and debug builds also compare the name to catch a colliding hash. Uniforms
+ * the source declares but the linker removed, like an unused u_Color, are
+ * reported once by Reflect; declarations in comments or inside #if blocks are
+ * not checked. Names the program never declared are reported once, on their
+ * first lookup.
+ *
+ * Set keeps a CPU copy of each value and drops the upload when it matches the
+ * last one, which is what most per-draw material uniforms do. Changed values
+ * are only marked dirty and Flush uploads them right before the draw, so a
+ * uniform set several times between two draws costs one glUniform* call.
+ */
+class UniformTable
+{
+public:
+	/* Per thread like BufferShadow's; Issued + Skipped counts every Set that was flushed or dropped */
+	struct Stats
+	{
+		unsigned int Issued = 0;
+		/* Unchanged values, values overwritten before a flush and uniforms that are not active */
+		unsigned int Skipped = 0;
+	};
+
+	/* label names the program in warnings; the sources list the declared uniforms */
+	void Reflect(unsigned int program, const std::string& label, const std::string& vertexSource, const std::string& fragmentSource);
+
+	/* Names the program never declared are registered with location -1, warning once */
+	UniformHandle GetHandle(UniformID id);
+
+	/* -1 when the program has no active uniform by that name */
+	int GetLocation(UniformID id);
+	inline int GetLocation(UniformHandle handle) const { return m_Uniforms[handle.Index].Location; }
+	const ShaderUniformBlock* FindBlock(UniformID id) const;
+
+	/* count values of type, e.g. 16 ints for a sampler array */
+	void Set(UniformHandle handle, UniformValueType type, int count, const void* value);
+	inline void Set(UniformID id, UniformValueType type, int count, const void* value) { Set(GetHandle(id), type, count, value); }
+	/* Uploads the dirty uniforms; the program must be bound */
+	void Flush();
+	/* Forgets the shadow values, after the program was changed through glUniform* directly */
+	void Invalidate();
+	inline bool IsDirty() const { return m_DirtyCount > 0; }
+
+	static Stats& GetStats();
+	static void ResetStats();
+
+	/* In registration order, indexed by UniformHandle */
+	inline const std::vector<ShaderUniform>& GetUniforms() const { return m_Uniforms; }
+	inline const std::vector<ShaderUniformBlock>& GetBlocks() const { return m_Blocks; }
+private:
+	struct HashIndex
+	{
+		unsigned int Hash;
+		unsigned int Index;
+	};
+
+	static const unsigned int NotFound = ~0u;
+
+	unsigned int Find(unsigned int hash) const;
+	unsigned int Add(const ShaderUniform& uniform);
+private:
+	std::vector<ShaderUniform> m_Uniforms;
+	/* One entry per uniform, sorted by hash */
+	std::vector<HashIndex> m_ByHash;
+	std::vector<ShaderUniformBlock> m_Blocks;
+	std::string m_Label;
+	unsigned int m_DirtyCount = 0;
+};
\ No newline at end of file
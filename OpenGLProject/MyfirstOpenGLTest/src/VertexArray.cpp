@@ -1,45 +1,186 @@
 #include "VertexArray.h"
 #include "Renderer.h"
 #include "VertexBufferLayout.h"
+#include "StreamingVertexBuffer.h"
 
 VertexArray::VertexArray()
+	: m_NextAttribute(0), m_BoundVertexBuffer(0)
 {
-	GLCall(glGenVertexArrays(1, &m_RendererID));
+	/* DSA functions need a created object, a glGen name only becomes one when first bound */
+	if (GLState::Get().UseDirectStateAccess())
+	{
+		GLCall(glCreateVertexArrays(1, &m_RendererID));
+	}
+	else
+	{
+		GLCall(glGenVertexArrays(1, &m_RendererID));
+	}
 }
 
 VertexArray::~VertexArray()
 {
+	GLState::Get().OnDeleteVertexArray(m_RendererID);
 	GLCall(glDeleteVertexArrays(1, &m_RendererID));
 }
 
 void VertexArray::Addbuffer(const VertexBuffer& vertexBuffer, const VertexBufferLayout& vertexBufferLayout)
 {
+	Addbuffer(vertexBuffer, vertexBufferLayout, m_NextAttribute);
+}
+
+void VertexArray::Addbuffer(const VertexBuffer& vertexBuffer, const VertexBufferLayout& vertexBufferLayout, unsigned int firstAttribute)
+{
+	SetAttributes(vertexBuffer.GetRendererID(), vertexBufferLayout, firstAttribute);
+}
+
+void VertexArray::Addbuffer(const StreamingVertexBuffer& vertexBuffer, const VertexBufferLayout& vertexBufferLayout)
+{
+	SetAttributes(vertexBuffer.GetRendererID(), vertexBufferLayout, m_NextAttribute);
+}
+
+void VertexArray::BeginAttributes(unsigned int vertexBuffer)
+{
+	/* With DSA the buffer is named in every SetAttribute, nothing has to be bound */
+	if (GLState::Get().UseDirectStateAccess())
+		return;
+
 	Bind();
-	vertexBuffer.Bind();
+	GLState::Get().BindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+}
+
+void VertexArray::SetAttributes(unsigned int vertexBuffer, const VertexBufferLayout& vertexBufferLayout, unsigned int firstAttribute)
+{
+	BeginAttributes(vertexBuffer);
 
 	const auto& elements = vertexBufferLayout.GetElements();
 	unsigned int offset = 0;
+	unsigned int location = firstAttribute;
 
-	for (unsigned int i = 0; i < elements.size(); i++)
+	for (const auto& element : elements)
 	{
-		const auto& element = elements[i];
-		
+		SetAttribute(vertexBuffer, location, VertexAttribute::Make(element.type, element.count, element.normalized == GL_TRUE, offset, element.divisor),
+			vertexBufferLayout.GetStride());
+
+		location += (element.count + 3) / 4;
+		offset += element.GetSize();
+	}
+
+	if (location > m_NextAttribute)
+		m_NextAttribute = location;
+}
+
+void VertexArray::SetAttribute(unsigned int vertexBuffer, unsigned int location, const VertexAttribute& attribute, unsigned int stride)
+{
+	unsigned int size = VertexBufferElement::GetSizeOfType(attribute.Type);
+	bool dsa = GLState::Get().UseDirectStateAccess();
+
+	/* Attributes wider than a vec4 (e.g. a per-instance mat4) span consecutive locations */
+	for (unsigned int component = 0; component < attribute.Count; component += 4, location++)
+	{
+		unsigned int count = attribute.Count - component < 4 ? attribute.Count - component : 4;
+		unsigned int offset = attribute.Offset + component * size;
+		GLboolean normalized = attribute.Normalized ? GL_TRUE : GL_FALSE;
+
+		if (dsa)
+		{
+			/* Like glVertexAttribPointer: each location reads through the binding of the same index */
+			GLCall(glEnableVertexArrayAttrib(m_RendererID, location));
+			GLCall(glVertexArrayAttribFormat(m_RendererID, location, count, attribute.Type, normalized, 0));
+			GLCall(glVertexArrayVertexBuffer(m_RendererID, location, vertexBuffer, offset, stride));
+			if (attribute.Divisor)
+			{
+				GLCall(glVertexArrayBindingDivisor(m_RendererID, location, attribute.Divisor));
+			}
+			continue;
+		}
+
 		/*Enable or disable a generic vertex attribute array*/
-		glEnableVertexAttribArray(i);
+		GLCall(glEnableVertexAttribArray(location));
 
 		/*define an array of generic vertex attribute data*/
-		glVertexAttribPointer(i, element.count, element.type, element.normalized, vertexBufferLayout.GetStride(), (const void*)offset);
-		offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
+		GLCall(glVertexAttribPointer(location, count, attribute.Type, normalized, stride, (const void*)(uintptr_t)offset));
+
+		/*modify the rate at which generic vertex attributes advance during instanced rendering*/
+		GLCall(glVertexAttribDivisor(location, attribute.Divisor));
+	}
+}
+
+void VertexArray::SetFormat(const VertexBufferLayout& vertexBufferLayout)
+{
+	ASSERT(vertexBufferLayout.HasSingleDivisor());
+
+	bool dsa = GLState::Get().UseDirectStateAccess();
+	if (!dsa)
+		Bind();
+
+	const auto& elements = vertexBufferLayout.GetElements();
+	unsigned int offset = 0;
+	unsigned int location = m_NextAttribute;
+
+	for (const auto& element : elements)
+	{
+		unsigned int size = VertexBufferElement::GetSizeOfType(element.type);
+
+		for (unsigned int component = 0; component < element.count; component += 4, location++)
+		{
+			unsigned int count = element.count - component < 4 ? element.count - component : 4;
 
+			if (dsa)
+			{
+				GLCall(glEnableVertexArrayAttrib(m_RendererID, location));
+				GLCall(glVertexArrayAttribFormat(m_RendererID, location, count, element.type, element.normalized, offset + component * size));
+				GLCall(glVertexArrayAttribBinding(m_RendererID, location, 0));
+			}
+			else
+			{
+				GLCall(glEnableVertexAttribArray(location));
+				GLCall(glVertexAttribFormat(location, count, element.type, element.normalized, offset + component * size));
+				GLCall(glVertexAttribBinding(location, 0));
+			}
+		}
+
+		offset += element.GetSize();
+	}
+
+	if (!elements.empty())
+	{
+		if (dsa)
+		{
+			GLCall(glVertexArrayBindingDivisor(m_RendererID, 0, elements.front().divisor));
+		}
+		else
+		{
+			GLCall(glVertexBindingDivisor(0, elements.front().divisor));
+		}
+	}
+
+	m_NextAttribute = location;
+}
+
+bool VertexArray::BindVertexBuffer(unsigned int vertexBuffer, unsigned int stride)
+{
+	if (m_BoundVertexBuffer == vertexBuffer)
+		return false;
+
+	if (GLState::Get().UseDirectStateAccess())
+	{
+		GLCall(glVertexArrayVertexBuffer(m_RendererID, 0, vertexBuffer, 0, stride));
+	}
+	else
+	{
+		Bind();
+		GLCall(glBindVertexBuffer(0, vertexBuffer, 0, stride));
 	}
+	m_BoundVertexBuffer = vertexBuffer;
+	return true;
 }
 
 void VertexArray::Bind() const
 {
-	GLCall(glBindVertexArray(m_RendererID));
+	GLState::Get().BindVertexArray(m_RendererID);
 }
 
 void VertexArray::UnBind() const
 {
-	GLCall(glBindVertexArray(0));
+	GLState::Get().BindVertexArray(0);
 }
@@ -1,19 +1,70 @@
 #pragma once
 
+#include <utility>
+
 #include "VertexBuffer.h"
+#include "StaticVertexLayout.h"
 
 class VertexBufferLayout;
+class StreamingVertexBuffer;
 
 class VertexArray
 {
 private:
 	unsigned int m_RendererID;
+	/* First attribute location not yet used by a previous Addbuffer */
+	unsigned int m_NextAttribute;
+
+	/* Binds the VAO and the buffer unless direct state access is used */
+	void BeginAttributes(unsigned int vertexBuffer);
+	/* Points locations starting at firstAttribute into vertexBuffer */
+	void SetAttributes(unsigned int vertexBuffer, const VertexBufferLayout& vertexBufferLayout, unsigned int firstAttribute);
+	void SetAttribute(unsigned int vertexBuffer, unsigned int location, const VertexAttribute& attribute, unsigned int stride);
+	/* Current buffer of binding 0 in the separate format path, 0 if none */
+	unsigned int m_BoundVertexBuffer;
+
+	template<size_t N, size_t... I>
+	void SetAttributes(unsigned int vertexBuffer, const StaticVertexLayout<N>& layout, unsigned int firstAttribute, std::index_sequence<I...>)
+	{
+		BeginAttributes(vertexBuffer);
+
+		int expand[] = { 0, (SetAttribute(vertexBuffer, firstAttribute + layout.Attributes[I].Location, layout.Attributes[I], layout.Stride), 0)... };
+		(void)expand;
+
+		if (firstAttribute + layout.LocationCount > m_NextAttribute)
+			m_NextAttribute = firstAttribute + layout.LocationCount;
+	}
 public:
 	VertexArray();
 	~VertexArray();
 
+	/* Attaches the buffer after the attributes of the previously added buffers */
 	void Addbuffer(const VertexBuffer& vertexBuffer, const VertexBufferLayout& vertexBufferLayout);
+	/* Attaches the buffer to locations [firstAttribute, firstAttribute + layout.GetAttributeCount()) */
+	void Addbuffer(const VertexBuffer& vertexBuffer, const VertexBufferLayout& vertexBufferLayout, unsigned int firstAttribute);
+	/* Streamed vertices are addressed with the base vertex returned by StreamingVertexBuffer::Map */
+	void Addbuffer(const StreamingVertexBuffer& vertexBuffer, const VertexBufferLayout& vertexBufferLayout);
+
+	/* Takes a VertexBuffer or StreamingVertexBuffer, the attribute setup is expanded at compile time */
+	template<typename Buffer, size_t N>
+	void Addbuffer(const Buffer& vertexBuffer, const StaticVertexLayout<N>& layout)
+	{
+		SetAttributes(vertexBuffer.GetRendererID(), layout, m_NextAttribute, std::make_index_sequence<N>());
+	}
+
+	/*
+	 * ARB_vertex_attrib_binding (GL 4.3): records only the attribute formats,
+	 * read from binding 0, so any buffer with this layout can be attached
+	 * later with BindVertexBuffer. The layout needs a single divisor.
+	 */
+	void SetFormat(const VertexBufferLayout& vertexBufferLayout);
+	/* Attaches the buffer to binding 0, returns false when it already was */
+	bool BindVertexBuffer(unsigned int vertexBuffer, unsigned int stride);
+	/* The VAO still points at a deleted buffer whose name may be reused, so the next BindVertexBuffer must be issued */
+	inline void OnDeleteBuffer(unsigned int buffer) { if (m_BoundVertexBuffer == buffer) m_BoundVertexBuffer = 0; }
 
 	void Bind() const;
 	void UnBind() const;
+
+	inline unsigned int GetAttributeCount() const { return m_NextAttribute; }
 };
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "VertexArrayCache.h"
+
+#include "Renderer.h"
+
+VertexArrayCache& VertexArrayCache::Get()
+{
+	static thread_local VertexArrayCache s_Cache;
+	return s_Cache;
+}
+
+VertexArrayCache::VertexArrayCache()
+	: m_Supported(GLEW_VERSION_4_3 || GLEW_ARB_vertex_attrib_binding), m_VertexAttribBinding(m_Supported), m_LiveCount(0)
+{
+}
+
+VertexArrayCache::~VertexArrayCache()
+{
+	/* At thread exit the context is usually gone already, it frees the VAOs with itself */
+	for (auto& entries : m_Entries)
+	{
+		for (Entry& entry : entries.second)
+			entry.Array.release();
+	}
+}
+
+size_t VertexArrayCache::KeyHash::operator()(const Key& key) const
+{
+	unsigned long long hash = key.LayoutHash;
+	hash = (hash ^ key.VertexBufferID) * 1099511628211ull;
+	hash = (hash ^ key.IndexBufferID) * 1099511628211ull;
+	return (size_t)hash;
+}
+
+void VertexArrayCache::Bind(const VertexBuffer& vertexBuffer, const VertexBufferLayout& layout, const IndexBuffer& indexBuffer)
+{
+	bool shared = m_VertexAttribBinding && layout.HasSingleDivisor();
+
+	Key key = { layout.GetHash(), 0, 0 };
+	if (!shared)
+	{
+		key.VertexBufferID = vertexBuffer.GetRendererID();
+		key.IndexBufferID = indexBuffer.GetRendererID();
+	}
+
+	std::vector<Entry>& entries = m_Entries[key];
+	VertexArray* found = nullptr;
+	for (Entry& entry : entries)
+	{
+		if (entry.Layout == layout)
+		{
+			found = entry.Array.get();
+			break;
+		}
+	}
+
+	if (found)
+	{
+		m_Stats.Hits++;
+	}
+	else
+	{
+		Entry entry = { std::make_unique<VertexArray>(), layout };
+		if (shared)
+		{
+			entry.Array->SetFormat(layout);
+			m_FormatArrays.push_back(entry.Array.get());
+		}
+		else
+		{
+			entry.Array->Addbuffer(vertexBuffer, layout);
+			if (entries.empty())
+			{
+				m_KeysByBuffer.emplace(key.VertexBufferID, key);
+				m_KeysByBuffer.emplace(key.IndexBufferID, key);
+			}
+		}
+
+		found = entry.Array.get();
+		entries.push_back(std::move(entry));
+		m_LiveCount++;
+		m_Stats.Misses++;
+	}
+
+	VertexArray& vertexArray = *found;
+	if (shared && vertexArray.BindVertexBuffer(vertexBuffer.GetRendererID(), layout.GetStride()))
+		m_Stats.VertexBufferBinds++;
+
+	/* GLState tracks the element binding per VAO, so this is elided while the mesh does not change */
+	vertexArray.Bind();
+	indexBuffer.Bind();
+}
+
+void VertexArrayCache::OnDeleteBuffer(unsigned int buffer)
+{
+	for (VertexArray* vertexArray : m_FormatArrays)
+		vertexArray->OnDeleteBuffer(buffer);
+
+	/* One at a time, erasing the other buffer's record can invalidate the end of an equal_range */
+	for (auto it = m_KeysByBuffer.find(buffer); it != m_KeysByBuffer.end(); it = m_KeysByBuffer.find(buffer))
+	{
+		Key key = it->second;
+		m_KeysByBuffer.erase(it);
+
+		auto entries = m_Entries.find(key);
+		m_LiveCount -= (unsigned int)entries->second.size();
+		m_Entries.erase(entries);
+
+		/* The same key is also listed under the other buffer of the mesh */
+		unsigned int other = key.VertexBufferID == buffer ? key.IndexBufferID : key.VertexBufferID;
+		auto range = m_KeysByBuffer.equal_range(other);
+		for (auto otherIt = range.first; otherIt != range.second; ++otherIt)
+		{
+			if (otherIt->second == key)
+			{
+				m_KeysByBuffer.erase(otherIt);
+				break;
+			}
+		}
+	}
+}
+
+void VertexArrayCache::Clear()
+{
+	m_Entries.clear();
+	m_KeysByBuffer.clear();
+	m_FormatArrays.clear();
+	m_LiveCount = 0;
+}
+
+void VertexArrayCache::SetVertexAttribBinding(bool enabled)
+{
+	if (m_VertexAttribBinding == (enabled && m_Supported))
+		return;
+
+	Clear();
+	m_VertexAttribBinding = enabled && m_Supported;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "VertexArray.h"
+#include "VertexBufferLayout.h"
+
+class IndexBuffer;
+
+/*
+ * Shares VAOs between meshes that do not own a VertexArray. With
+ * ARB_vertex_attrib_binding a VAO only records attribute formats, so it is
+ * keyed by the layout alone and switching meshes rebinds the vertex buffer
+ * (glBindVertexBuffer) and the index buffer, not the VAO. Without it, or for
+ * layouts mixing divisors, the key also holds both buffers and a VAO is only
+ * reused when the same mesh is drawn again.
+ *
+ * Sharing saves VAOs, not calls: a mesh drawn through a shared VAO costs a
+ * vertex buffer and an element buffer bind where its own VAO costs one
+ * glBindVertexArray, so a frame of distinct meshes makes one call more each.
+ *
+ * One instance per thread, like GLState. Buffers must report their deletion
+ * through OnDeleteBuffer so no VAO keeps pointing at a reused name.
+ */
+class VertexArrayCache
+{
+public:
+	struct Stats
+	{
+		unsigned int Hits = 0;
+		unsigned int Misses = 0;
+		/* glBindVertexBuffer calls issued in the shared format path */
+		unsigned int VertexBufferBinds = 0;
+
+		inline float GetHitRate() const { return Hits + Misses ? (float)Hits / (Hits + Misses) : 0.0f; }
+	};
+
+	static VertexArrayCache& Get();
+	~VertexArrayCache();
+
+	/* Binds a VAO reading vertexBuffer through layout, with indexBuffer as its element buffer */
+	void Bind(const VertexBuffer& vertexBuffer, const VertexBufferLayout& layout, const IndexBuffer& indexBuffer);
+
+	void OnDeleteBuffer(unsigned int buffer);
+	/* Deletes every cached VAO; call it while the context is still current */
+	void Clear();
+
+	/* Falls back to keying by buffers, e.g. to compare both paths; ignored when the extension is missing */
+	void SetVertexAttribBinding(bool enabled);
+	inline bool UsesVertexAttribBinding() const { return m_VertexAttribBinding; }
+
+	inline unsigned int GetLiveCount() const { return m_LiveCount; }
+	inline const Stats& GetStats() const { return m_Stats; }
+	inline void ResetStats() { m_Stats = Stats(); }
+private:
+	VertexArrayCache();
+
+	struct Key
+	{
+		unsigned long long LayoutHash;
+		/* Both 0 when the VAO only holds formats */
+		unsigned int VertexBufferID;
+		unsigned int IndexBufferID;
+
+		inline bool operator==(const Key& other) const
+		{
+			return LayoutHash == other.LayoutHash && VertexBufferID == other.VertexBufferID && IndexBufferID == other.IndexBufferID;
+		}
+	};
+
+	struct KeyHash
+	{
+		size_t operator()(const Key& key) const;
+	};
+
+	struct Entry
+	{
+		std::unique_ptr<VertexArray> Array;
+		VertexBufferLayout Layout;
+	};
+private:
+	bool m_Supported;
+	bool m_VertexAttribBinding;
+	/* Usually one entry per key, more when different layouts share a hash */
+	std::unordered_map<Key, std::vector<Entry>, KeyHash> m_Entries;
+	/* Keys of the per-mesh VAOs under both their buffers, a deletion only visits its own */
+	std::unordered_multimap<unsigned int, Key> m_KeysByBuffer;
+	/* The VAOs that only hold formats, they can have any buffer bound */
+	std::vector<VertexArray*> m_FormatArrays;
+	unsigned int m_LiveCount;
+	Stats m_Stats;
+};
\ No newline at end of file
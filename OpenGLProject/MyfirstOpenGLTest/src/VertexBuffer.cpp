@@ -1,24 +1,52 @@
 #include "VertexBuffer.h"
 #include "Renderer.h"
+#include "VertexArrayCache.h"
 
-VertexBuffer::VertexBuffer(const void* data, unsigned int size)
+VertexBuffer::VertexBuffer(const void* data, unsigned int size, BufferUsage usage /*= BufferUsage::Static*/)
+	: m_Size(size), m_Usage(usage)
+{
+	m_RendererID = CreateBuffer(GL_ARRAY_BUFFER, data, size, usage);
+
+	if (usage != BufferUsage::Static)
+		m_Shadow = std::make_unique<BufferShadow>(m_RendererID, data, size);
+}
+
+VertexBuffer::VertexBuffer(unsigned int size, BufferUsage usage /*= BufferUsage::Dynamic*/)
+	: VertexBuffer(nullptr, size, usage)
 {
-	GLCall(glGenBuffers(1, &m_RendererID));
-	GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
-	GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
 }
 
 VertexBuffer::~VertexBuffer()
 {
+	GLState::Get().OnDeleteBuffer(m_RendererID);
+	VertexArrayCache::Get().OnDeleteBuffer(m_RendererID);
 	GLCall(glDeleteBuffers(1, &m_RendererID));
 }
 
 void VertexBuffer::Bind() const
 {
-	GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+	GLState::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+}
+
+void VertexBuffer::Update(unsigned int offset, const void* data, unsigned int size)
+{
+	ASSERT(offset + size <= m_Size);
+
+	if (m_Shadow)
+	{
+		m_Shadow->Write(offset, data, size);
+		return;
+	}
+
+	UploadBuffer(m_RendererID, offset, data, size, m_Usage);
+}
+
+void VertexBuffer::SetData(const void* data, unsigned int size)
+{
+	Update(0, data, size);
 }
 
 void VertexBuffer::UnBind() const
 {
-	GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
+	GLState::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
 }
@@ -1,13 +1,35 @@
 #pragma once
 
+#include <memory>
+
+#include "BufferShadow.h"
+
 class VertexBuffer 
 {
 private:
 	unsigned int m_RendererID;
+	unsigned int m_Size;
+	BufferUsage m_Usage;
+	/* Dynamic and Stream buffers keep a CPU copy so Update() calls can be merged */
+	std::unique_ptr<BufferShadow> m_Shadow;
 public:
-	VertexBuffer(const void* data, unsigned int size);
+	VertexBuffer(const void* data, unsigned int size, BufferUsage usage = BufferUsage::Static);
+	/* Allocates an empty store to be filled with Update or SetData */
+	VertexBuffer(unsigned int size, BufferUsage usage = BufferUsage::Dynamic);
 	~VertexBuffer();
 
+	/*
+	 * Writes size bytes at offset. Dynamic and Stream buffers upload the write,
+	 * merged with the other writes of the frame, before the next draw; Static
+	 * buffers upload it immediately.
+	 */
+	void Update(unsigned int offset, const void* data, unsigned int size);
+	void SetData(const void* data, unsigned int size);
+
 	void Bind() const;
 	void UnBind() const;
+
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+	inline unsigned int GetSize() const { return m_Size; }
+	inline BufferUsage GetUsage() const { return m_Usage; }
 };
\ No newline at end of file
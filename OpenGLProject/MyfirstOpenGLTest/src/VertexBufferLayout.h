@@ -8,6 +8,11 @@ struct VertexBufferElement
 	unsigned int type;
 	unsigned int count;
 	unsigned char normalized;
+	/* 0 advances per vertex, N advances once every N instances */
+	unsigned int divisor;
+
+	/* Bytes the element takes in a vertex, a packed type holds all four components in one 32-bit word */
+	inline unsigned int GetSize() const { return IsPacked(type) ? GetSizeOfType(type) : count * GetSizeOfType(type); }
 
 	static unsigned int GetSizeOfType(unsigned int type)
 	{
@@ -16,50 +21,136 @@ struct VertexBufferElement
 		case GL_FLOAT:						return 4;
 		case GL_UNSIGNED_INT:		return 4;
 		case GL_UNSIGNED_BYTE:		return 1;
+		case GL_HALF_FLOAT:			return 2;
+		case GL_SHORT:						return 2;
+		case GL_UNSIGNED_SHORT:	return 2;
+		case GL_INT_2_10_10_10_REV:	return 4;
 		}
 
 		ASSERT(false);
 		return 0;
 	}
+
+	static bool IsPacked(unsigned int type)
+	{
+		return type == GL_INT_2_10_10_10_REV;
+	}
 };
 
+/* Built at runtime with tightly packed elements; vertex structs known at compile time can use StaticVertexLayout instead */
 class VertexBufferLayout
 {
 public:
 	VertexBufferLayout()
-		: m_Stride(0) {}
+		: m_Stride(0), m_Hash(FnvOffsetBasis) {}
 
 	template<typename T>
-	void Push(unsigned int count)
+	void Push(unsigned int count, unsigned int divisor = 0)
 	{
-		static_assert(false);
+		static_assert(sizeof(T) == 0, "VertexBufferLayout::Push: unsupported attribute type");
 	}
 
-	template<>
-	void Push<float>(unsigned int count)
+	/* For types without a C++ counterpart, e.g. Push(GL_HALF_FLOAT, 2, false) or Push(GL_INT_2_10_10_10_REV, 4, true) */
+	void Push(unsigned int type, unsigned int count, bool normalized, unsigned int divisor = 0)
 	{
-		m_Elements.push_back({ GL_FLOAT, count, GL_FALSE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
+		/* GL only accepts packed types with all four components */
+		ASSERT(!VertexBufferElement::IsPacked(type) || count == 4);
+
+		m_Elements.push_back({ type, count, (unsigned char)(normalized ? GL_TRUE : GL_FALSE), divisor });
+		m_Stride += m_Elements.back().GetSize();
+
+		HashCombine(type);
+		HashCombine(count);
+		HashCombine(normalized ? 1 : 0);
+		HashCombine(divisor);
 	}
 
-	template<>
-	void Push<unsigned int>(unsigned int count)
+	inline const std::vector<VertexBufferElement>& GetElements() const { return m_Elements; }
+	inline unsigned int GetStride() const { return m_Stride; }
+	/* FNV-1a over every element, kept up to date by Push so it costs nothing to read */
+	inline unsigned long long GetHash() const { return m_Hash; }
+
+	/* True when every element advances at the same rate, so the layout fits a single vertex buffer binding */
+	inline bool HasSingleDivisor() const
 	{
-		m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
+		for (const auto& element : m_Elements)
+		{
+			if (element.divisor != m_Elements.front().divisor)
+				return false;
+		}
+		return true;
 	}
 
-	template<>
-	void Push<unsigned char>(unsigned int count)
+	bool operator==(const VertexBufferLayout& other) const
 	{
-		m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
+		if (m_Hash != other.m_Hash || m_Stride != other.m_Stride || m_Elements.size() != other.m_Elements.size())
+			return false;
+
+		for (unsigned int i = 0; i < m_Elements.size(); i++)
+		{
+			const VertexBufferElement& a = m_Elements[i];
+			const VertexBufferElement& b = other.m_Elements[i];
+			if (a.type != b.type || a.count != b.count || a.normalized != b.normalized || a.divisor != b.divisor)
+				return false;
+		}
+		return true;
 	}
 
-	inline const std::vector<VertexBufferElement> GetElements() const& { return m_Elements; }
-	inline unsigned int GetStride() const { return m_Stride; }
+	/* Number of attribute locations the layout occupies, a mat4 (16 floats) takes 4 */
+	inline unsigned int GetAttributeCount() const
+	{
+		unsigned int locations = 0;
+		for (const auto& element : m_Elements)
+			locations += (element.count + 3) / 4;
+		return locations;
+	}
 
+private:
+	static const unsigned long long FnvOffsetBasis = 14695981039346656037ull;
+	static const unsigned long long FnvPrime = 1099511628211ull;
+
+	void HashCombine(unsigned int value)
+	{
+		for (unsigned int byte = 0; byte < 4; byte++)
+		{
+			m_Hash ^= (value >> (byte * 8)) & 0xff;
+			m_Hash *= FnvPrime;
+		}
+	}
 private:
 	std::vector<VertexBufferElement> m_Elements;
 	unsigned int m_Stride;
-};
\ No newline at end of file
+	unsigned long long m_Hash;
+};
+
+/* Explicit specializations have to live at namespace scope to be portable (GCC/Clang reject them in the class) */
+template<>
+inline void VertexBufferLayout::Push<float>(unsigned int count, unsigned int divisor)
+{
+	Push(GL_FLOAT, count, false, divisor);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned int>(unsigned int count, unsigned int divisor)
+{
+	Push(GL_UNSIGNED_INT, count, false, divisor);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned char>(unsigned int count, unsigned int divisor)
+{
+	Push(GL_UNSIGNED_BYTE, count, true, divisor);
+}
+
+/* 16-bit integers are normalized, shorts to [-1, 1] and unsigned shorts to [0, 1] */
+template<>
+inline void VertexBufferLayout::Push<short>(unsigned int count, unsigned int divisor)
+{
+	Push(GL_SHORT, count, true, divisor);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned short>(unsigned int count, unsigned int divisor)
+{
+	Push(GL_UNSIGNED_SHORT, count, true, divisor);
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include "VertexQuantizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "glm/gtc/packing.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace VertexQuantizer
+{
+	static glm::vec3 ReadVec3(const unsigned char* vertex, int offset)
+	{
+		const float* data = (const float*)(vertex + offset);
+		return glm::vec3(data[0], data[1], data[2]);
+	}
+
+	static glm::vec2 ReadVec2(const unsigned char* vertex, int offset)
+	{
+		const float* data = (const float*)(vertex + offset);
+		return glm::vec2(data[0], data[1]);
+	}
+
+	static float Sign(float value)
+	{
+		return value >= 0.0f ? 1.0f : -1.0f;
+	}
+
+	glm::vec2 EncodeOctahedral(const glm::vec3& normal)
+	{
+		glm::vec3 n = normal / (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z));
+		if (n.z >= 0.0f)
+			return glm::vec2(n.x, n.y);
+
+		return glm::vec2((1.0f - std::abs(n.y)) * Sign(n.x), (1.0f - std::abs(n.x)) * Sign(n.y));
+	}
+
+	glm::vec3 DecodeOctahedral(const glm::vec2& encoded)
+	{
+		glm::vec3 n(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+		if (n.z < 0.0f)
+		{
+			float x = n.x;
+			n.x = (1.0f - std::abs(n.y)) * Sign(x);
+			n.y = (1.0f - std::abs(x)) * Sign(n.y);
+		}
+		return glm::normalize(n);
+	}
+
+	Mesh Quantize(const void* vertices, unsigned int vertexCount, unsigned int vertexStride, const Attributes& attributes,
+		PositionFormat positionFormat /*= PositionFormat::Snorm16*/)
+	{
+		ASSERT(attributes.Position >= 0);
+
+		const unsigned char* source = (const unsigned char*)vertices;
+
+		Mesh mesh;
+		mesh.Stats.VertexCount = vertexCount;
+		mesh.Stats.SourceBytes = (size_t)vertexCount * vertexStride;
+
+		/* Snorm16 positions are relative to a cube around the bounds, the largest extent sets the precision */
+		glm::vec3 center(0.0f);
+		float scale = 1.0f;
+		if (positionFormat == PositionFormat::Snorm16 && vertexCount > 0)
+		{
+			glm::vec3 min = ReadVec3(source, attributes.Position);
+			glm::vec3 max = min;
+			for (unsigned int i = 1; i < vertexCount; i++)
+			{
+				glm::vec3 position = ReadVec3(source + i * vertexStride, attributes.Position);
+				min = glm::min(min, position);
+				max = glm::max(max, position);
+			}
+
+			center = (min + max) * 0.5f;
+			glm::vec3 extent = (max - min) * 0.5f;
+			scale = std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-20f));
+			mesh.PositionDecode = glm::scale(glm::translate(glm::mat4(1.0f), center), glm::vec3(scale));
+		}
+
+		/* Unorm16 covers [0, 1] at 1/65535 steps, tiling UVs need the range of half floats */
+		bool unitTexCoords = true;
+		if (attributes.TexCoord >= 0)
+		{
+			for (unsigned int i = 0; i < vertexCount && unitTexCoords; i++)
+			{
+				glm::vec2 texCoord = ReadVec2(source + i * vertexStride, attributes.TexCoord);
+				unitTexCoords = texCoord.x >= 0.0f && texCoord.x <= 1.0f && texCoord.y >= 0.0f && texCoord.y <= 1.0f;
+			}
+		}
+
+		if (positionFormat == PositionFormat::Snorm16)
+			mesh.Layout.Push<short>(4);
+		else
+			mesh.Layout.Push(GL_HALF_FLOAT, 4, false);
+
+		if (attributes.TexCoord >= 0)
+		{
+			if (unitTexCoords)
+				mesh.Layout.Push<unsigned short>(2);
+			else
+				mesh.Layout.Push(GL_HALF_FLOAT, 2, false);
+		}
+
+		if (attributes.Normal >= 0)
+			mesh.Layout.Push(GL_INT_2_10_10_10_REV, 4, true);
+
+		unsigned int stride = mesh.Layout.GetStride();
+		mesh.Vertices.resize((size_t)vertexCount * stride);
+		mesh.Stats.PackedBytes = mesh.Vertices.size();
+
+		for (unsigned int i = 0; i < vertexCount; i++)
+		{
+			const unsigned char* vertex = source + i * vertexStride;
+			unsigned char* packed = mesh.Vertices.data() + (size_t)i * stride;
+
+			glm::vec3 position = ReadVec3(vertex, attributes.Position);
+			glm::vec3 decodedPosition;
+			if (positionFormat == PositionFormat::Snorm16)
+			{
+				glm::uint64 bits = glm::packSnorm4x16(glm::vec4((position - center) / scale, 1.0f));
+				decodedPosition = glm::vec3(glm::unpackSnorm4x16(bits)) * scale + center;
+				std::memcpy(packed, &bits, sizeof(bits));
+			}
+			else
+			{
+				glm::uint64 bits = glm::packHalf4x16(glm::vec4(position, 1.0f));
+				decodedPosition = glm::vec3(glm::unpackHalf4x16(bits));
+				std::memcpy(packed, &bits, sizeof(bits));
+			}
+			packed += sizeof(glm::uint64);
+			mesh.Stats.MaxPositionError = std::max(mesh.Stats.MaxPositionError, glm::length(decodedPosition - position));
+
+			if (attributes.TexCoord >= 0)
+			{
+				glm::vec2 texCoord = ReadVec2(vertex, attributes.TexCoord);
+				glm::vec2 decodedTexCoord;
+				glm::uint16 bits[2];
+				if (unitTexCoords)
+				{
+					bits[0] = glm::packUnorm1x16(texCoord.x);
+					bits[1] = glm::packUnorm1x16(texCoord.y);
+					decodedTexCoord = glm::vec2(glm::unpackUnorm1x16(bits[0]), glm::unpackUnorm1x16(bits[1]));
+				}
+				else
+				{
+					bits[0] = glm::packHalf1x16(texCoord.x);
+					bits[1] = glm::packHalf1x16(texCoord.y);
+					decodedTexCoord = glm::vec2(glm::unpackHalf1x16(bits[0]), glm::unpackHalf1x16(bits[1]));
+				}
+				std::memcpy(packed, bits, sizeof(bits));
+				packed += sizeof(bits);
+
+				glm::vec2 error = glm::abs(decodedTexCoord - texCoord);
+				mesh.Stats.MaxTexCoordError = std::max(mesh.Stats.MaxTexCoordError, std::max(error.x, error.y));
+			}
+
+			if (attributes.Normal >= 0)
+			{
+				glm::vec3 normal = glm::normalize(ReadVec3(vertex, attributes.Normal));
+				glm::uint32 bits = glm::packSnorm3x10_1x2(glm::vec4(EncodeOctahedral(normal), 0.0f, 0.0f));
+				std::memcpy(packed, &bits, sizeof(bits));
+				packed += sizeof(bits);
+
+				glm::vec3 decodedNormal = DecodeOctahedral(glm::vec2(glm::unpackSnorm3x10_1x2(bits)));
+				float angle = std::acos(glm::clamp(glm::dot(decodedNormal, normal), -1.0f, 1.0f));
+				mesh.Stats.MaxNormalError = std::max(mesh.Stats.MaxNormalError, glm::degrees(angle));
+			}
+		}
+
+		return mesh;
+	}
+}
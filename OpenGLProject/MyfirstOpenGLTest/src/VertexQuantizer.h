@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "VertexBufferLayout.h"
+
+#include "glm/glm.hpp"
+
+/*
+ * Converts float vertices into smaller GL vertex formats, meant to run once
+ * when a mesh is built or loaded:
+ *
+ *   position   4 x GL_SHORT normalized to the mesh bounds (8 bytes instead of 12),
+ *              or 4 x GL_HALF_FLOAT; w is 1 so the shader can use it as a vec4
+ *   texCoord   2 x GL_UNSIGNED_SHORT normalized when all UVs are in [0, 1],
+ *              2 x GL_HALF_FLOAT when they tile (4 bytes instead of 8)
+ *   normal     GL_INT_2_10_10_10_REV holding an octahedral encoding in x and y
+ *              (4 bytes instead of 12), decoded in the vertex shader
+ *
+ * The packed layout keeps the order position, texCoord, normal so shaders
+ * reading position at location 0 and texCoord at 1 work unchanged.
+ */
+namespace VertexQuantizer
+{
+	enum class PositionFormat
+	{
+		Snorm16, Half
+	};
+
+	/* Byte offsets of the float attributes inside a source vertex, -1 when the vertex has none */
+	struct Attributes
+	{
+		int Position = 0;
+		int TexCoord = -1;
+		int Normal = -1;
+	};
+
+	struct Report
+	{
+		unsigned int VertexCount = 0;
+		size_t SourceBytes = 0;
+		size_t PackedBytes = 0;
+
+		/* Largest round trip errors: object space units, UV units and degrees */
+		float MaxPositionError = 0.0f;
+		float MaxTexCoordError = 0.0f;
+		float MaxNormalError = 0.0f;
+
+		inline float GetSavedFraction() const { return SourceBytes ? 1.0f - (float)PackedBytes / SourceBytes : 0.0f; }
+	};
+
+	struct Mesh
+	{
+		std::vector<unsigned char> Vertices;
+		VertexBufferLayout Layout;
+		/*
+		 * Maps decoded Snorm16 positions back to object space; multiply it into
+		 * the model matrix. It is a uniform scale plus translation, so normals
+		 * need no extra correction.
+		 */
+		glm::mat4 PositionDecode = glm::mat4(1.0f);
+		Report Stats;
+	};
+
+	Mesh Quantize(const void* vertices, unsigned int vertexCount, unsigned int vertexStride, const Attributes& attributes,
+		PositionFormat positionFormat = PositionFormat::Snorm16);
+
+	/* Maps a unit vector onto the [-1, 1] square by folding the lower hemisphere of an octahedron */
+	glm::vec2 EncodeOctahedral(const glm::vec3& normal);
+	glm::vec3 DecodeOctahedral(const glm::vec2& encoded);
+}
\ No newline at end of file